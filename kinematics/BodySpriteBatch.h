@@ -0,0 +1,157 @@
+#pragma once
+
+// Std. Includes
+#include <cmath>
+#include <vector>
+
+// GLEW
+#include <GL/glew.h>
+
+// Classes
+#include "Shader.h"
+#include "simulation/BodyStore.h"
+
+#define BODY_COLOR_BY_SPEED 0
+#define BODY_COLOR_BY_MASS 1
+
+#define BODY_SPRITE_VERTEX_FLOATS 5
+
+// Bodies drawn as lit sphere impostors, one point sprite per body, in one draw call.
+// Each vertex is the interpolated position, the radius of the midsection and the value the colour is
+// taken from (speed, or log10 of mass); the vertex shader sizes the sprite by perspective and maps the
+// value onto a colour ramp over the frame's range. The vertex stream is rebuilt every frame straight
+// from the position arrays and uploaded in one go.
+class BodySpriteBatch
+{
+public:
+	BodySpriteBatch()
+	{
+
+	}
+	BodySpriteBatch(const BodySpriteBatch&) = delete;
+	BodySpriteBatch& operator=(const BodySpriteBatch&) = delete;
+
+	void update(const BodyStore& bodies, const float& interpolationFactor, const int& colorMode)
+	{
+		const std::size_t count = bodies.size();
+		vertices.resize(count * BODY_SPRITE_VERTEX_FLOATS);
+
+		const Vector3Array& from = bodies.previous().coordinates;
+		const Vector3Array& to = bodies.current().coordinates;
+		const Vector3Array& velocity = bodies.current().velocity;
+
+		colorMin = HUGE_VALF;
+		colorMax = -HUGE_VALF;
+
+		GLfloat* vertex = vertices.data();
+		for (std::size_t i = 0; i < count; ++i, vertex += BODY_SPRITE_VERTEX_FLOATS)
+		{
+			vertex[0] = from.x[i] + interpolationFactor * (to.x[i] - from.x[i]);
+			vertex[1] = from.y[i] + interpolationFactor * (to.y[i] - from.y[i]);
+			vertex[2] = from.z[i] + interpolationFactor * (to.z[i] - from.z[i]);
+
+			// Midsection of a sphere of radius r is pi * r^2
+			vertex[3] = std::sqrt(bodies.midsection[i] * (1.0f / 3.14159265f));
+
+			if (colorMode == BODY_COLOR_BY_MASS)
+				vertex[4] = std::log10(bodies.mass[i] > 0.0f ? bodies.mass[i] : 1.0e-30f);
+			else
+				vertex[4] = std::sqrt(velocity.x[i] * velocity.x[i] + velocity.y[i] * velocity.y[i] + velocity.z[i] * velocity.z[i]);
+
+			colorMin = vertex[4] < colorMin ? vertex[4] : colorMin;
+			colorMax = vertex[4] > colorMax ? vertex[4] : colorMax;
+		}
+
+		if (count == 0)
+			return;
+
+		if (VAO == 0)
+			createBuffers();
+
+		// A fresh store every frame, so the driver never waits for the previous frame's draw
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GLfloat), vertices.data(), GL_STREAM_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	// pointScale: pixels covered by one metre one metre away from the camera
+	void draw(const Shader& shader, const float& pointScale)
+	{
+		if (vertices.empty())
+			return;
+
+		if (shader.Program != uniformProgram)
+		{
+			pointScaleUniform = shader.getUniform<float>("pointScale");
+			colorMinUniform = shader.getUniform<float>("colorMin");
+			colorRangeUniform = shader.getUniform<float>("colorRange");
+			uniformProgram = shader.Program;
+		}
+
+		shader.set(pointScaleUniform, pointScale);
+		shader.set(colorMinUniform, colorMin);
+		shader.set(colorRangeUniform, colorMax > colorMin ? colorMax - colorMin : 1.0f);
+
+		glBindVertexArray(VAO);
+		glDrawArrays(GL_POINTS, 0, (GLsizei)getBodyCount());
+		glBindVertexArray(0);
+	}
+
+	void release()
+	{
+		if (VAO != 0)
+		{
+			glDeleteVertexArrays(1, &VAO);
+			glDeleteBuffers(1, &VBO);
+			VAO = 0;
+			VBO = 0;
+		}
+
+		vertices.clear();
+	}
+
+	std::size_t getBodyCount() const { return vertices.size() / BODY_SPRITE_VERTEX_FLOATS; }
+	// Range of the colour ramp in the last update: m/s, or log10 of kg
+	float getColorMin() const { return colorMin; }
+	float getColorMax() const { return colorMax; }
+
+	~BodySpriteBatch()
+	{
+		release();
+	}
+
+private:
+	void createBuffers()
+	{
+		glGenVertexArrays(1, &VAO);
+		glGenBuffers(1, &VBO);
+
+		glBindVertexArray(VAO);
+
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, BODY_SPRITE_VERTEX_FLOATS * sizeof(GLfloat), (GLvoid*)0);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, BODY_SPRITE_VERTEX_FLOATS * sizeof(GLfloat), (GLvoid*)(3 * sizeof(GLfloat)));
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, BODY_SPRITE_VERTEX_FLOATS * sizeof(GLfloat), (GLvoid*)(4 * sizeof(GLfloat)));
+		glEnableVertexAttribArray(2);
+
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+	}
+
+private:
+	GLuint VAO = 0;
+	GLuint VBO = 0;
+
+	float colorMin = 0.0f;
+	float colorMax = 0.0f;
+
+	// Uniform handles of the program they were resolved for
+	GLuint uniformProgram = 0;
+	Uniform<float> pointScaleUniform;
+	Uniform<float> colorMinUniform;
+	Uniform<float> colorRangeUniform;
+
+	std::vector<GLfloat> vertices;
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+// GLEW
+#include <GL/glew.h>
+
+// GLM
+#include <glm/glm/mat4x4.hpp>
+#include <glm/glm/gtc/type_ptr.hpp>
+
+#define CAMERA_UNIFORM_BLOCK_BINDING 0
+
+// View and projection matrices shared by every shader through the std140 block
+//   layout (std140) uniform Camera { mat4 view; mat4 projection; };
+// bound to CAMERA_UNIFORM_BLOCK_BINDING; one upload per frame serves all programs.
+class CameraUniformBuffer
+{
+public:
+	CameraUniformBuffer()
+	{
+
+	}
+	CameraUniformBuffer(const CameraUniformBuffer&) = delete;
+	CameraUniformBuffer& operator=(const CameraUniformBuffer&) = delete;
+
+	void update(const glm::mat4& view, const glm::mat4& projection)
+	{
+		if (UBO == 0)
+		{
+			glGenBuffers(1, &UBO);
+			glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+			glBufferData(GL_UNIFORM_BUFFER, 2 * sizeof(glm::mat4), NULL, GL_DYNAMIC_DRAW);
+			glBindBufferBase(GL_UNIFORM_BUFFER, CAMERA_UNIFORM_BLOCK_BINDING, UBO);
+		}
+		else
+			glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+
+		// std140 lays a mat4 out as four vec4 columns, exactly as glm stores it
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(glm::mat4), glm::value_ptr(view));
+		glBufferSubData(GL_UNIFORM_BUFFER, sizeof(glm::mat4), sizeof(glm::mat4), glm::value_ptr(projection));
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	}
+
+	void release()
+	{
+		if (UBO != 0)
+		{
+			glDeleteBuffers(1, &UBO);
+			UBO = 0;
+		}
+	}
+
+	~CameraUniformBuffer()
+	{
+		release();
+	}
+
+private:
+	GLuint UBO = 0;
+};
@@ -0,0 +1,174 @@
+#pragma once
+
+// Std. Includes
+#include <vector>
+
+// GLEW
+#include <GL/glew.h>
+
+// GLM
+#include <glm/glm/vec3.hpp>
+
+// Classes
+#include "Frustum.h"
+#include "MaterialPoint.h"
+#include "simulation/BodyStore.h"
+
+#define MIN_FORCE_ARROW_CAPACITY 64
+#define FORCE_ARROW_INSTANCE_FLOATS 9
+
+// Force vectors of every body, drawn with one instanced call.
+// The mesh is a single segment from t = 0 to t = 1; each instance is an origin, a vector and a colour
+// (9 floats), and the vertex shader places the segment at origin + t * vector. The instance buffer
+// grows geometrically and is refilled every frame, since every force changes with every step.
+// Arrows whose bounding box lies outside the view frustum are left out.
+class ForceArrowBatch
+{
+public:
+	ForceArrowBatch()
+	{
+
+	}
+	ForceArrowBatch(const ForceArrowBatch&) = delete;
+	ForceArrowBatch& operator=(const ForceArrowBatch&) = delete;
+
+	// Collects the shown, non-zero forces of objects inside frustum, starting at their interpolated positions
+	void update(const std::vector<MaterialPoint>& objects, const BodyStore& bodies, const float& interpolationFactor, const Frustum& frustum)
+	{
+		instances.clear();
+		culledArrows = 0;
+
+		for (std::size_t i = 0; i < objects.size(); ++i)
+		{
+			const MaterialPoint& object = objects[i];
+			if (!object.drawDevelopedForceStatus && !object.drawDragForceStatus && !object.drawGravitationalForceStatus && !object.drawNormalReactionForceStatus)
+				continue;
+
+			const glm::vec3 origin = bodies.getInterpolatedCoordinates(i, interpolationFactor);
+
+			if (object.drawDevelopedForceStatus)
+				addArrow(frustum, origin, bodies.developedForce.get(i), glm::vec3(0.0f, 0.392f, 0.0f));
+			if (object.drawDragForceStatus)
+				addArrow(frustum, origin, bodies.dragForce.get(i), glm::vec3(0.545f, 0.0f, 0.545f));
+			if (object.drawGravitationalForceStatus)
+				addArrow(frustum, origin, bodies.gravitationalForce.get(i), glm::vec3(0.416f, 0.353f, 0.804f));
+			if (object.drawNormalReactionForceStatus)
+				addArrow(frustum, origin, bodies.normalReactionForce.get(i), glm::vec3(1.0f, 0.549f, 0.0f));
+		}
+
+		if (instances.empty())
+			return;
+
+		if (VAO == 0)
+			createBuffers();
+
+		const std::size_t arrowCount = getArrowCount();
+		glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+		if (arrowCount > capacity)
+		{
+			while (capacity < arrowCount)
+				capacity = capacity > 0 ? 2 * capacity : MIN_FORCE_ARROW_CAPACITY;
+			glBufferData(GL_ARRAY_BUFFER, capacity * FORCE_ARROW_INSTANCE_FLOATS * sizeof(GLfloat), NULL, GL_STREAM_DRAW);
+		}
+		glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(GLfloat), instances.data());
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	void draw() const
+	{
+		if (instances.empty())
+			return;
+
+		glLineWidth(2.0f);
+		glBindVertexArray(VAO);
+		glDrawArraysInstanced(GL_LINES, 0, 2, (GLsizei)getArrowCount());
+		glBindVertexArray(0);
+	}
+
+	void release()
+	{
+		if (VAO != 0)
+		{
+			glDeleteVertexArrays(1, &VAO);
+			glDeleteBuffers(1, &segmentVBO);
+			glDeleteBuffers(1, &instanceVBO);
+			VAO = 0;
+			segmentVBO = 0;
+			instanceVBO = 0;
+		}
+
+		capacity = 0;
+		instances.clear();
+	}
+
+	// Arrows drawn by the single draw call, and left out by the last update() as off screen
+	std::size_t getArrowCount() const { return instances.size() / FORCE_ARROW_INSTANCE_FLOATS; }
+	std::size_t getCulledArrowCount() const { return culledArrows; }
+
+	~ForceArrowBatch()
+	{
+		release();
+	}
+
+private:
+	void addArrow(const Frustum& frustum, const glm::vec3& origin, const glm::vec3& force, const glm::vec3& color)
+	{
+		if (force.x == 0.0f && force.y == 0.0f && force.z == 0.0f)
+			return;
+
+		BoundingBox box;
+		box.extend(origin);
+		box.extend(origin + force);
+		if (!frustum.intersects(box))
+		{
+			++culledArrows;
+			return;
+		}
+
+		const GLfloat instance[FORCE_ARROW_INSTANCE_FLOATS] =
+		{
+			origin.x, origin.y, origin.z,
+			force.x, force.y, force.z,
+			color.r, color.g, color.b
+		};
+		instances.insert(instances.end(), instance, instance + FORCE_ARROW_INSTANCE_FLOATS);
+	}
+
+	void createBuffers()
+	{
+		const GLfloat segment[] = { 0.0f, 1.0f };
+
+		glGenVertexArrays(1, &VAO);
+		glGenBuffers(1, &segmentVBO);
+		glGenBuffers(1, &instanceVBO);
+
+		glBindVertexArray(VAO);
+
+		glBindBuffer(GL_ARRAY_BUFFER, segmentVBO);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(segment), segment, GL_STATIC_DRAW);
+		glVertexAttribPointer(0, 1, GL_FLOAT, GL_FALSE, sizeof(GLfloat), (GLvoid*)0);
+		glEnableVertexAttribArray(0);
+
+		glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+		for (GLuint attribute = 1; attribute <= 3; ++attribute)
+		{
+			glVertexAttribPointer(attribute, 3, GL_FLOAT, GL_FALSE, FORCE_ARROW_INSTANCE_FLOATS * sizeof(GLfloat), (GLvoid*)(3 * (attribute - 1) * sizeof(GLfloat)));
+			glEnableVertexAttribArray(attribute);
+			glVertexAttribDivisor(attribute, 1);
+		}
+
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+	}
+
+private:
+	GLuint VAO = 0;
+	GLuint segmentVBO = 0;
+	GLuint instanceVBO = 0;
+
+	// In arrows
+	std::size_t capacity = 0;
+	std::size_t culledArrows = 0;
+
+	std::vector<GLfloat> instances;
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+// Std. Includes
+#include <cmath>
+
+// GLM
+#include <glm/glm/vec3.hpp>
+#include <glm/glm/vec4.hpp>
+#include <glm/glm/mat4x4.hpp>
+
+// Axis-aligned bounding box; empty until the first point is added
+struct BoundingBox
+{
+	glm::vec3 min = glm::vec3(HUGE_VALF);
+	glm::vec3 max = glm::vec3(-HUGE_VALF);
+
+	void extend(const glm::vec3& point)
+	{
+		min = glm::vec3(point.x < min.x ? point.x : min.x, point.y < min.y ? point.y : min.y, point.z < min.z ? point.z : min.z);
+		max = glm::vec3(point.x > max.x ? point.x : max.x, point.y > max.y ? point.y : max.y, point.z > max.z ? point.z : max.z);
+	}
+	bool isEmpty() const { return min.x > max.x; }
+};
+
+// View frustum as six inward-facing planes, extracted from projection * view (Gribb-Hartmann)
+class Frustum
+{
+public:
+	Frustum(const glm::mat4& projectionView)
+	{
+		// glm is column-major: row i is (m[0][i], m[1][i], m[2][i], m[3][i])
+		const glm::vec4 row0(projectionView[0][0], projectionView[1][0], projectionView[2][0], projectionView[3][0]);
+		const glm::vec4 row1(projectionView[0][1], projectionView[1][1], projectionView[2][1], projectionView[3][1]);
+		const glm::vec4 row2(projectionView[0][2], projectionView[1][2], projectionView[2][2], projectionView[3][2]);
+		const glm::vec4 row3(projectionView[0][3], projectionView[1][3], projectionView[2][3], projectionView[3][3]);
+
+		planes[0] = row3 + row0; // left
+		planes[1] = row3 - row0; // right
+		planes[2] = row3 + row1; // bottom
+		planes[3] = row3 - row1; // top
+		planes[4] = row3 + row2; // near
+		planes[5] = row3 - row2; // far
+	}
+
+	// False only if the box is entirely outside one of the planes; boxes near a corner may pass
+	bool intersects(const BoundingBox& box) const
+	{
+		if (box.isEmpty())
+			return false;
+
+		for (int i = 0; i < 6; ++i)
+		{
+			// Corner of the box furthest along the plane's normal
+			const glm::vec4& plane = planes[i];
+			const float distance =
+				plane.x * (plane.x > 0.0f ? box.max.x : box.min.x) +
+				plane.y * (plane.y > 0.0f ? box.max.y : box.min.y) +
+				plane.z * (plane.z > 0.0f ? box.max.z : box.min.z) + plane.w;
+			if (distance < 0.0f)
+				return false;
+		}
+		return true;
+	}
+
+private:
+	glm::vec4 planes[6];
+};
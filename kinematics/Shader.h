@@ -3,12 +3,21 @@
 
 #include <fstream>
 #include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include<glm/glm/mat4x4.hpp>
 #include <glm/glm/gtc/type_ptr.hpp>
 
-#include <glm/glm/mat4x4.hpp>
-#include <glm/glm/gtc/type_ptr.hpp>
+#include <glm/glm/vec3.hpp>
+
+// Location of a uniform of type T, resolved once with Shader::getUniform() instead of on every set
+template <class T>
+struct Uniform
+{
+    GLint location = -1;
+};
 
 class Shader
 {
@@ -45,9 +54,89 @@ public:
         {
             std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
         }
+        // 2. Take the linked program from the binary cache, or compile it and refresh the cache
+        const std::string binaryPath = getProgramBinaryPath(vertexPath, fragmentPath);
+        const unsigned long long key = getProgramBinaryKey(vertexCode, fragmentCode);
+        loadedFromBinaryCache = loadProgramBinary(binaryPath, key);
+        if (!loadedFromBinaryCache)
+        {
+            compileProgram(vertexCode, fragmentCode);
+            saveProgramBinary(binaryPath, key);
+        }
+        // Look every active uniform up once, so that setting one never asks the driver again
+        cacheUniformLocations();
+
+    }
+
+    // Whether the program came from the on-disk binary cache instead of being compiled
+    bool isLoadedFromBinaryCache() const { return loadedFromBinaryCache; }
+
+    // Uses the current shader
+    void Use() const
+    {
+        glUseProgram(this->Program);
+    }
+
+    // Typed handles for the render loop; an unknown name gives location -1, which GL ignores
+    template <class T>
+    Uniform<T> getUniform(const std::string& name) const
+    {
+        Uniform<T> uniform;
+        uniform.location = getUniformLocation(name);
+        return uniform;
+    }
+
+    void set(const Uniform<glm::mat4>& uniform, const glm::mat4& matrix) const
+    {
+        glUniformMatrix4fv(uniform.location, 1, GL_FALSE, glm::value_ptr(matrix));
+    }
+
+    void set(const Uniform<glm::vec3>& uniform, const glm::vec3& vector) const
+    {
+        glUniform3fv(uniform.location, 1, glm::value_ptr(vector));
+    }
+
+    void set(const Uniform<float>& uniform, const float& value) const
+    {
+        glUniform1f(uniform.location, value);
+    }
+
+    // By name, through the cache
+    void setMatrix4(const std::string& name, const glm::mat4& matrix) const
+    {
+        glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(matrix));
+    }
+
+    void setVector3(const std::string& name, const glm::vec3& vector) const
+    {
+        glUniform3fv(getUniformLocation(name), 1, glm::value_ptr(vector));
+    }
+
+    void setFloat(const std::string& name, const float& value) const
+    {
+        glUniform1f(getUniformLocation(name), value);
+    }
+
+    GLint getUniformLocation(const std::string& name) const
+    {
+        const std::unordered_map<std::string, GLint>::const_iterator location = uniformLocations.find(name);
+        return location != uniformLocations.end() ? location->second : -1;
+    }
+
+    // Connects a uniform block of the program to a uniform buffer binding point; programs without the block are left alone
+    void bindUniformBlock(const GLchar* name, const GLuint& bindingPoint) const
+    {
+        const GLuint blockIndex = glGetUniformBlockIndex(this->Program, name);
+        if (blockIndex != GL_INVALID_INDEX)
+            glUniformBlockBinding(this->Program, blockIndex, bindingPoint);
+    }
+
+private:
+    void compileProgram(const std::string& vertexCode, const std::string& fragmentCode)
+    {
         const GLchar* vShaderCode = vertexCode.c_str();
         const GLchar* fShaderCode = fragmentCode.c_str();
-        // 2. Compile shaders
+        // Compile shaders
         GLuint vertex, fragment;
         GLint success;
         GLchar infoLog[512];
@@ -77,6 +166,8 @@ public:
         this->Program = glCreateProgram();
         glAttachShader(this->Program, vertex);
         glAttachShader(this->Program, fragment);
+        if (isProgramBinarySupported())
+            glProgramParameteri(this->Program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
         glLinkProgram(this->Program);
         // Print linking errors if any
         glGetProgramiv(this->Program, GL_LINK_STATUS, &success);
@@ -88,22 +179,133 @@ public:
         // Delete the shaders as they're linked into our program now and no longer necessery
         glDeleteShader(vertex);
         glDeleteShader(fragment);
+    }
 
+    // Program binaries need GL 4.1 or ARB_get_program_binary, and a driver offering at least one format
+    static bool isProgramBinarySupported()
+    {
+        if (!GLEW_ARB_get_program_binary)
+            return false;
+
+        GLint formatCount = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+        return formatCount > 0;
     }
 
-    // Uses the current shader
-    void Use() const
+    // Next to the vertex shader, named after every stage: programs sharing a vertex shader keep binaries of their own
+    static std::string getProgramBinaryPath(const std::string& vertexPath, const std::string& fragmentPath)
     {
-        glUseProgram(this->Program);
+        const std::string::size_type directoryEnd = fragmentPath.find_last_of("/\\");
+        const std::string fragmentName = directoryEnd == std::string::npos ? fragmentPath : fragmentPath.substr(directoryEnd + 1);
+        return vertexPath + "+" + fragmentName + ".programBinary";
     }
 
-    void setMatrix4(const std::string& name, const glm::mat4& matrix) const
+    // FNV-1a over both sources and the strings identifying the driver: a binary is only valid for the
+    // exact sources and driver build it came from
+    static unsigned long long getProgramBinaryKey(const std::string& vertexCode, const std::string& fragmentCode)
     {
-        glUniformMatrix4fv(glGetUniformLocation(Program, name.c_str()), 1, GL_FALSE, glm::value_ptr(matrix));
+        unsigned long long hash = 14695981039346656037ull;
+        const auto mix = [&hash](const char* text)
+        {
+            for (const char* c = text; *c != '\0'; ++c)
+                hash = (hash ^ (unsigned char)*c) * 1099511628211ull;
+            hash = (hash ^ 0xffu) * 1099511628211ull;
+        };
+
+        mix(vertexCode.c_str());
+        mix(fragmentCode.c_str());
+        for (const GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION })
+        {
+            const GLubyte* value = glGetString(name);
+            mix(value != NULL ? (const char*)value : "");
+        }
+        return hash;
     }
 
-    void setVector3(const std::string& name, const glm::vec3& vector) const
+    // Cache file: key, binary format, length, then the binary itself
+    bool loadProgramBinary(const std::string& path, const unsigned long long& key)
     {
-        glUniform3fv(glGetUniformLocation(Program, name.c_str()), 1, glm::value_ptr(vector));
+        if (!isProgramBinarySupported())
+            return false;
+
+        std::ifstream file(path, std::ios::binary);
+        unsigned long long fileKey = 0;
+        GLenum format = 0;
+        GLint length = 0;
+        if (!file.read((char*)&fileKey, sizeof(fileKey)) || !file.read((char*)&format, sizeof(format)) || !file.read((char*)&length, sizeof(length)))
+            return false;
+        if (fileKey != key || length <= 0)
+            return false;
+
+        std::vector<char> binary(length);
+        if (!file.read(binary.data(), length))
+            return false;
+
+        this->Program = glCreateProgram();
+        glProgramBinary(this->Program, format, binary.data(), length);
+
+        // The driver may still reject it, e.g. after an update that kept its version string
+        GLint success = 0;
+        glGetProgramiv(this->Program, GL_LINK_STATUS, &success);
+        if (!success)
+        {
+            glDeleteProgram(this->Program);
+            this->Program = 0;
+            return false;
+        }
+        return true;
+    }
+
+    void saveProgramBinary(const std::string& path, const unsigned long long& key) const
+    {
+        GLint success = 0;
+        glGetProgramiv(this->Program, GL_LINK_STATUS, &success);
+        if (!success || !isProgramBinarySupported())
+            return;
+
+        GLint length = 0;
+        glGetProgramiv(this->Program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0)
+            return;
+
+        std::vector<char> binary(length);
+        GLenum format = 0;
+        glGetProgramBinary(this->Program, length, &length, &format, binary.data());
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write((const char*)&key, sizeof(key));
+        file.write((const char*)&format, sizeof(format));
+        file.write((const char*)&length, sizeof(length));
+        file.write(binary.data(), length);
+    }
+
+    void cacheUniformLocations()
+    {
+        GLint uniformCount = 0;
+        glGetProgramiv(this->Program, GL_ACTIVE_UNIFORMS, &uniformCount);
+
+        GLchar name[256];
+        for (GLint i = 0; i < uniformCount; ++i)
+        {
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(this->Program, (GLuint)i, sizeof(name), &length, &size, &type, name);
+
+            // Members of uniform blocks have no location of their own
+            const GLint location = glGetUniformLocation(this->Program, name);
+            if (location >= 0)
+            {
+                const std::string uniformName(name, length);
+                uniformLocations[uniformName] = location;
+
+                // Arrays are listed as "name[0]" but usually looked up as "name"
+                if (uniformName.size() > 3 && uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0)
+                    uniformLocations[uniformName.substr(0, uniformName.size() - 3)] = location;
+            }
+        }
     }
+
+    bool loadedFromBinaryCache = false;
+    std::unordered_map<std::string, GLint> uniformLocations;
 };
\ No newline at end of file
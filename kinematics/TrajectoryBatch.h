@@ -0,0 +1,434 @@
+#pragma once
+
+// Std. Includes
+#include <vector>
+
+// GLEW
+#include <GL/glew.h>
+
+// GLM
+#include <glm/glm/vec3.hpp>
+#include <glm/glm/common.hpp>
+#include <glm/glm/geometric.hpp>
+
+// Classes
+#include "Frustum.h"
+#include "MaterialPoint.h"
+
+#define MIN_TRAJECTORY_REGION_CAPACITY 256
+#define TRAJECTORY_VERTEX_FLOATS 6
+#define TRAJECTORY_CHUNK_SEGMENTS 256 // a power of two of at least 2^(TRAJECTORY_LOD_LEVELS - 1)
+// Level l draws every 2^l-th point of a chunk; the coarsest keeps only its two end points
+#define TRAJECTORY_LOD_LEVELS 9
+#define DEFAULT_TRAJECTORY_SCREEN_ERROR 1.0f
+
+// Every trajectory in one vertex buffer, drawn with a single glMultiDrawElementsBaseVertex call.
+// Vertices are x, y, z, r, g, b; every body owns a region of the buffer, found by its handle, whose
+// capacity doubles as its trajectory grows, and only the points appended since the last update are uploaded into it. A region
+// that outgrows its place moves to the end of the buffer; the buffer itself is laid out again, without
+// the holes, only when it is full or mostly holes. A region is uploaded whole after a move, a colour
+// change or a trajectory compaction.
+// Trajectories are culled in chunks of TRAJECTORY_CHUNK_SEGMENTS segments: chunk c covers points
+// c * SEGMENTS to (c + 1) * SEGMENTS, sharing its end point with the next one, and keeps a bounding box
+// that is extended as points are uploaded. Only chunks inside the view frustum are drawn.
+// Visible chunks are drawn at a level of detail: a static index buffer holds, for every level l, the
+// indices 0, 2^l, 2 * 2^l, ... SEGMENTS of a chunk, and each chunk is one entry of the multi-draw call
+// with its first vertex as the base vertex. A complete chunk knows how far its points lie from the
+// polyline of every level, and is drawn at the coarsest level whose error, projected at the distance of
+// its bounding box, stays within the allowed number of pixels. The pyramid keeps the end points of every
+// chunk at every level, so neighbours drawn at different levels still meet, and the vertices drawn grow
+// with the size of the trajectory on screen rather than with its number of points.
+class TrajectoryBatch
+{
+public:
+	TrajectoryBatch()
+	{
+
+	}
+	TrajectoryBatch(const TrajectoryBatch&) = delete;
+	TrajectoryBatch& operator=(const TrajectoryBatch&) = delete;
+
+	// Brings the buffer up to date with the trajectories of objects and collects their chunks inside frustum.
+	// pixelScale: pixels covered by one metre one metre away from cameraPosition
+	void update(const std::vector<MaterialPoint>& objects, const Frustum& frustum, const glm::vec3& cameraPosition, const float& pixelScale)
+	{
+		lastUploadSize = 0;
+		drawnVertices = 0;
+		visibleVertices = 0;
+		culledVertices = 0;
+
+		// Space the regions will need after the update, packed and with the grown ones moved to the end
+		std::size_t required = 0;
+		std::size_t grown = used;
+		for (std::size_t i = 0; i < objects.size(); ++i)
+		{
+			Region& region = getRegion(objects[i].getBody());
+			const std::size_t pointCount = objects[i].getTrajectory().getPointCount();
+			const std::size_t regionCapacity = getRegionCapacity(region, pointCount);
+
+			required += regionCapacity;
+			if (pointCount > region.capacity)
+				grown += regionCapacity;
+		}
+
+		if (VAO == 0 || grown > capacity || (used > 2 * required && used > MIN_TRAJECTORY_REGION_CAPACITY))
+			layOut(objects, required);
+
+		counts.clear();
+		indexOffsets.clear();
+		baseVertices.clear();
+		for (std::size_t i = 0; i < objects.size(); ++i)
+		{
+			const MaterialPoint& object = objects[i];
+			Region& region = getRegion(object.getBody());
+			const Trajectory& trajectory = object.getTrajectory();
+			const std::size_t pointCount = trajectory.getPointCount();
+
+			if (pointCount > region.capacity)
+			{
+				// Leaves a hole; the room at the end was checked above
+				region.first = used;
+				region.capacity = getRegionCapacity(region, pointCount);
+				region.uploadedPoints = 0;
+				used += region.capacity;
+			}
+
+			std::size_t firstPoint = region.uploadedPoints;
+			if (trajectory.getRevision() != region.revision || pointCount < region.uploadedPoints || object.trajectoryColor != region.color)
+				firstPoint = 0;
+
+			if (firstPoint < pointCount)
+				upload(region, trajectory, object.trajectoryColor, firstPoint);
+
+			region.uploadedPoints = pointCount;
+			region.revision = trajectory.getRevision();
+			region.color = object.trajectoryColor;
+
+			if (object.drawTrajectoryStatus && pointCount >= 2)
+				addVisibleChunks(region, pointCount, frustum, cameraPosition, pixelScale);
+		}
+	}
+
+	void draw() const
+	{
+		if (counts.empty())
+			return;
+
+		// GLEW declares the argument arrays non-const
+		glLineWidth(2.0f);
+		glBindVertexArray(VAO);
+		glMultiDrawElementsBaseVertex(GL_LINE_STRIP, const_cast<GLsizei*>(counts.data()), GL_UNSIGNED_SHORT,
+			const_cast<void**>(indexOffsets.data()), (GLsizei)counts.size(), const_cast<GLint*>(baseVertices.data()));
+		glBindVertexArray(0);
+	}
+
+	// Pixels a chunk drawn at a coarser level may be off from its full polyline
+	void setMaxScreenError(const float& pixels) { maxScreenError = pixels; }
+	float getMaxScreenError() const { return maxScreenError; }
+
+	void release()
+	{
+		if (VAO != 0)
+		{
+			glDeleteVertexArrays(1, &VAO);
+			glDeleteBuffers(1, &VBO);
+			glDeleteBuffers(1, &EBO);
+			VAO = 0;
+			VBO = 0;
+			EBO = 0;
+		}
+
+		regions.clear();
+		capacity = 0;
+		used = 0;
+	}
+
+	// Bytes written by the last update()
+	std::size_t getLastUploadSize() const { return lastUploadSize; }
+	// Bytes allocated on the GPU
+	std::size_t getCapacity() const { return capacity * TRAJECTORY_VERTEX_FLOATS * sizeof(GLfloat); }
+	// Chunks drawn by the single draw call
+	std::size_t getDrawCount() const { return counts.size(); }
+	// Vertices of shown trajectories in the last update(): drawn, in visible chunks at full detail, and in culled chunks
+	std::size_t getDrawnVertexCount() const { return drawnVertices; }
+	std::size_t getVisibleVertexCount() const { return visibleVertices; }
+	std::size_t getCulledVertexCount() const { return culledVertices; }
+
+	~TrajectoryBatch()
+	{
+		release();
+	}
+
+private:
+	struct Chunk
+	{
+		BoundingBox bounds;
+		// error[l]: furthest a point of the chunk lies from the polyline of level l, m. Only known once the
+		// chunk is complete; the last, open chunk of a trajectory is always drawn at full detail.
+		float error[TRAJECTORY_LOD_LEVELS];
+		bool complete = false;
+	};
+
+	struct Region
+	{
+		// Generation of the body handle the region belongs to
+		std::uint32_t generation = 0;
+
+		// In vertices
+		std::size_t first = 0;
+		std::size_t capacity = 0;
+		std::size_t uploadedPoints = 0;
+		std::uint64_t revision = 0;
+		glm::vec3 color = glm::vec3(-1.0f);
+
+		std::vector<Chunk> chunks;
+	};
+
+	// Region of a body, found by the slot of its handle. A region left by a removed body is never drawn again,
+	// and its space is reclaimed by the next lay-out; a new body in the same slot starts with an empty one.
+	Region& getRegion(const BodyHandle& body)
+	{
+		if (body.slot >= regions.size())
+			regions.resize(body.slot + 1);
+
+		Region& region = regions[body.slot];
+		if (region.generation != body.generation)
+		{
+			region = Region();
+			region.generation = body.generation;
+		}
+		return region;
+	}
+
+	static std::size_t getRegionCapacity(const Region& region, const std::size_t& pointCount)
+	{
+		std::size_t regionCapacity = region.capacity > 0 ? region.capacity : MIN_TRAJECTORY_REGION_CAPACITY;
+		while (regionCapacity < pointCount)
+			regionCapacity *= 2;
+		return regionCapacity;
+	}
+
+	// Packs every region from the start of a buffer with room for twice the required space
+	void layOut(const std::vector<MaterialPoint>& objects, const std::size_t& required)
+	{
+		if (VAO == 0)
+			createBuffers();
+
+		const std::size_t newCapacity = 2 * required > MIN_TRAJECTORY_REGION_CAPACITY ? 2 * required : MIN_TRAJECTORY_REGION_CAPACITY;
+		if (newCapacity > capacity)
+		{
+			glBindBuffer(GL_ARRAY_BUFFER, VBO);
+			glBufferData(GL_ARRAY_BUFFER, newCapacity * TRAJECTORY_VERTEX_FLOATS * sizeof(GLfloat), NULL, GL_DYNAMIC_DRAW);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			capacity = newCapacity;
+		}
+
+		used = 0;
+		for (std::size_t i = 0; i < objects.size(); ++i)
+		{
+			Region& region = getRegion(objects[i].getBody());
+			region.capacity = getRegionCapacity(region, objects[i].getTrajectory().getPointCount());
+			region.first = used;
+			region.uploadedPoints = 0;
+			used += region.capacity;
+		}
+	}
+
+	void upload(Region& region, const Trajectory& trajectory, const glm::vec3& color, const std::size_t& firstPoint)
+	{
+		trajectory.copyVertices(points, firstPoint);
+
+		const std::size_t pointCount = points.size() / 3;
+
+		// A point starting a chunk also ends the previous one
+		if (firstPoint == 0)
+			region.chunks.clear();
+		region.chunks.resize((firstPoint + pointCount - 1) / TRAJECTORY_CHUNK_SEGMENTS + 1);
+		for (std::size_t k = 0; k < pointCount; ++k)
+		{
+			const std::size_t point = firstPoint + k;
+			const glm::vec3 position(points[3 * k + 0], points[3 * k + 1], points[3 * k + 2]);
+
+			region.chunks[point / TRAJECTORY_CHUNK_SEGMENTS].bounds.extend(position);
+			if (point % TRAJECTORY_CHUNK_SEGMENTS == 0 && point > 0)
+				region.chunks[point / TRAJECTORY_CHUNK_SEGMENTS - 1].bounds.extend(position);
+		}
+
+		// Chunks whose end point arrived with this upload
+		for (std::size_t chunk = firstPoint > 0 ? (firstPoint - 1) / TRAJECTORY_CHUNK_SEGMENTS : 0; (chunk + 1) * TRAJECTORY_CHUNK_SEGMENTS < firstPoint + pointCount; ++chunk)
+		{
+			if (region.chunks[chunk].complete)
+				continue;
+
+			const std::size_t begin = chunk * TRAJECTORY_CHUNK_SEGMENTS;
+			if (begin >= firstPoint)
+				measureLevels(region.chunks[chunk], &points[3 * (begin - firstPoint)]);
+			else
+			{
+				// Starts before this upload; read it back from the trajectory
+				trajectory.copyVertices(chunkPoints, begin, TRAJECTORY_CHUNK_SEGMENTS + 1);
+				measureLevels(region.chunks[chunk], chunkPoints.data());
+			}
+		}
+
+		vertices.resize(pointCount * TRAJECTORY_VERTEX_FLOATS);
+		for (std::size_t k = 0; k < pointCount; ++k)
+		{
+			vertices[TRAJECTORY_VERTEX_FLOATS * k + 0] = points[3 * k + 0];
+			vertices[TRAJECTORY_VERTEX_FLOATS * k + 1] = points[3 * k + 1];
+			vertices[TRAJECTORY_VERTEX_FLOATS * k + 2] = points[3 * k + 2];
+			vertices[TRAJECTORY_VERTEX_FLOATS * k + 3] = color.r;
+			vertices[TRAJECTORY_VERTEX_FLOATS * k + 4] = color.g;
+			vertices[TRAJECTORY_VERTEX_FLOATS * k + 5] = color.b;
+		}
+
+		const std::size_t size = vertices.size() * sizeof(GLfloat);
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glBufferSubData(GL_ARRAY_BUFFER, (region.first + firstPoint) * TRAJECTORY_VERTEX_FLOATS * sizeof(GLfloat), size, vertices.data());
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		lastUploadSize += size;
+	}
+
+	// Fills in chunk.error from its TRAJECTORY_CHUNK_SEGMENTS + 1 points, as x, y, z triples
+	static void measureLevels(Chunk& chunk, const GLfloat* points)
+	{
+		chunk.error[0] = 0.0f;
+		for (int level = 1; level < TRAJECTORY_LOD_LEVELS; ++level)
+		{
+			const std::size_t stride = (std::size_t)1 << level;
+
+			// Each level is bounded by the finer one, so that a coarser level never looks more accurate
+			float error = chunk.error[level - 1];
+			for (std::size_t j = 0; j < TRAJECTORY_CHUNK_SEGMENTS; j += stride)
+			{
+				const glm::vec3 a(points[3 * j + 0], points[3 * j + 1], points[3 * j + 2]);
+				const glm::vec3 b(points[3 * (j + stride) + 0], points[3 * (j + stride) + 1], points[3 * (j + stride) + 2]);
+				for (std::size_t k = j + 1; k < j + stride; ++k)
+				{
+					const float distance = getDistanceToSegment(glm::vec3(points[3 * k + 0], points[3 * k + 1], points[3 * k + 2]), a, b);
+					error = distance > error ? distance : error;
+				}
+			}
+			chunk.error[level] = error;
+		}
+		chunk.complete = true;
+	}
+
+	static float getDistanceToSegment(const glm::vec3& point, const glm::vec3& a, const glm::vec3& b)
+	{
+		const glm::vec3 segment = b - a;
+		const float lengthSquared = glm::dot(segment, segment);
+		float t = lengthSquared > 0.0f ? glm::dot(point - a, segment) / lengthSquared : 0.0f;
+		t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+		return glm::length(point - (a + t * segment));
+	}
+
+	// Distance from point to the nearest point of box; 0 inside it
+	static float getDistance(const glm::vec3& point, const BoundingBox& box)
+	{
+		const glm::vec3 outside = glm::max(glm::max(box.min - point, point - box.max), glm::vec3(0.0f));
+		return glm::length(outside);
+	}
+
+	void addVisibleChunks(const Region& region, const std::size_t& pointCount, const Frustum& frustum, const glm::vec3& cameraPosition, const float& pixelScale)
+	{
+		for (std::size_t chunk = 0; chunk * TRAJECTORY_CHUNK_SEGMENTS + 1 < pointCount; ++chunk)
+		{
+			const Chunk& data = region.chunks[chunk];
+			const std::size_t begin = chunk * TRAJECTORY_CHUNK_SEGMENTS;
+			const std::size_t end = begin + TRAJECTORY_CHUNK_SEGMENTS < pointCount - 1 ? begin + TRAJECTORY_CHUNK_SEGMENTS : pointCount - 1;
+
+			// Each chunk owns its points but the first, which belongs to the previous one
+			const std::size_t ownVertices = end - begin + (chunk == 0 ? 1 : 0);
+			if (!frustum.intersects(data.bounds))
+			{
+				culledVertices += ownVertices;
+				continue;
+			}
+			visibleVertices += ownVertices;
+
+			// Coarsest level whose error covers no more than maxScreenError pixels at the chunk's distance
+			int level = 0;
+			if (data.complete)
+			{
+				const float allowedError = maxScreenError * getDistance(cameraPosition, data.bounds) / pixelScale;
+				while (level + 1 < TRAJECTORY_LOD_LEVELS && data.error[level + 1] <= allowedError)
+					++level;
+			}
+
+			// The open chunk draws a prefix of the full-detail indices
+			const std::size_t count = data.complete ? levelCounts[level] : end - begin + 1;
+
+			counts.push_back((GLsizei)count);
+			indexOffsets.push_back((void*)(levelOffsets[level] * sizeof(GLushort)));
+			baseVertices.push_back((GLint)(region.first + begin));
+
+			drawnVertices += count;
+		}
+	}
+
+	void createBuffers()
+	{
+		glGenVertexArrays(1, &VAO);
+		glGenBuffers(1, &VBO);
+
+		glBindVertexArray(VAO);
+
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, TRAJECTORY_VERTEX_FLOATS * sizeof(GLfloat), (GLvoid*)0);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, TRAJECTORY_VERTEX_FLOATS * sizeof(GLfloat), (GLvoid*)(3 * sizeof(GLfloat)));
+		glEnableVertexAttribArray(1);
+
+		// Index pattern of every level, one after the other; the binding is part of the VAO
+		std::vector<GLushort> indices;
+		for (int level = 0; level < TRAJECTORY_LOD_LEVELS; ++level)
+		{
+			levelOffsets[level] = indices.size();
+			for (std::size_t index = 0; index <= TRAJECTORY_CHUNK_SEGMENTS; index += (std::size_t)1 << level)
+				indices.push_back((GLushort)index);
+			levelCounts[level] = indices.size() - levelOffsets[level];
+		}
+
+		glGenBuffers(1, &EBO);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort), indices.data(), GL_STATIC_DRAW);
+
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+	}
+
+private:
+	GLuint VAO = 0;
+	GLuint VBO = 0;
+	GLuint EBO = 0;
+
+	// Start and length of each level's indices in EBO
+	std::size_t levelOffsets[TRAJECTORY_LOD_LEVELS];
+	std::size_t levelCounts[TRAJECTORY_LOD_LEVELS];
+
+	float maxScreenError = DEFAULT_TRAJECTORY_SCREEN_ERROR;
+
+	// In vertices: allocated, and taken by regions including holes
+	std::size_t capacity = 0;
+	std::size_t used = 0;
+
+	// Indexed by the slot of the body handle
+	std::vector<Region> regions;
+
+	// Arguments of the multi-draw call, one entry per chunk
+	std::vector<GLsizei> counts;
+	std::vector<void*> indexOffsets;
+	std::vector<GLint> baseVertices;
+
+	std::size_t lastUploadSize = 0;
+	std::size_t drawnVertices = 0;
+	std::size_t visibleVertices = 0;
+	std::size_t culledVertices = 0;
+
+	// Upload staging
+	std::vector<GLfloat> points;
+	std::vector<GLfloat> chunkPoints;
+	std::vector<GLfloat> vertices;
+};
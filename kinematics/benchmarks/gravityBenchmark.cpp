@@ -0,0 +1,78 @@
+// Direct-sum gravity kernel benchmark.
+// Runs every kernel the CPU supports on one thread and prints pair interactions per second per core,
+// together with the largest relative deviation from the scalar kernel.
+
+// Std. Includes
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Classes
+#include "simulation/GravityKernels.h"
+
+int main()
+{
+	typedef std::chrono::steady_clock Clock;
+
+	const std::size_t bodyCounts[] = { 256, 1024, 4096, 16384 };
+	const float softeningSquared = 0.01f * 0.01f;
+	const double minimumSeconds = 0.25;
+
+	const SimdLevel supported = detectSimdLevel();
+	std::printf("Supported instruction set: %s\n\n", getSimdLevelName(supported));
+	std::printf("%8s  %-8s  %16s  %12s\n", "bodies", "kernel", "interactions/s", "max rel. err");
+
+	std::mt19937 generator(42);
+	std::normal_distribution<float> position(0.0f, 1000.0f);
+	std::uniform_real_distribution<float> mass(1.0e3f, 1.0e6f);
+
+	for (const std::size_t count : bodyCounts)
+	{
+		std::vector<float> x(count), y(count), z(count), m(count);
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			x[i] = position(generator);
+			y[i] = position(generator);
+			z[i] = position(generator);
+			m[i] = mass(generator);
+		}
+
+		const GravitySources sources = { x.data(), y.data(), z.data(), m.data(), count };
+
+		std::vector<float> referenceX(count), referenceY(count), referenceZ(count);
+		gravityKernelScalar(sources, 0, count, softeningSquared, referenceX.data(), referenceY.data(), referenceZ.data());
+
+		for (int level = SIMD_SCALAR; level <= supported; ++level)
+		{
+			const GravityKernel kernel = getGravityKernel(static_cast<SimdLevel>(level));
+			std::vector<float> ax(count), ay(count), az(count);
+
+			std::size_t repetitions = 0;
+			const Clock::time_point start = Clock::now();
+			double seconds = 0.0;
+			do
+			{
+				kernel(sources, 0, count, softeningSquared, ax.data(), ay.data(), az.data());
+				++repetitions;
+				seconds = std::chrono::duration<double>(Clock::now() - start).count();
+			} while (seconds < minimumSeconds);
+
+			float maxError = 0.0f;
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const float dx = ax[i] - referenceX[i], dy = ay[i] - referenceY[i], dz = az[i] - referenceZ[i];
+				const float reference = std::sqrt(referenceX[i] * referenceX[i] + referenceY[i] * referenceY[i] + referenceZ[i] * referenceZ[i]);
+				if (reference > 0.0f)
+					maxError = std::max(maxError, std::sqrt(dx * dx + dy * dy + dz * dz) / reference);
+			}
+
+			const double interactions = static_cast<double>(count) * static_cast<double>(count) * static_cast<double>(repetitions);
+			std::printf("%8zu  %-8s  %16.3e  %12.2e\n", count, getSimdLevelName(static_cast<SimdLevel>(level)), interactions / seconds, maxError);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,154 @@
+// State precision benchmark.
+// For every precision policy: single-thread step throughput of a direct-sum cluster and of bodies near an
+// astronomical object, and the orbit error of a low Earth orbit, where float coordinates are 0.5 m apart.
+
+// Std. Includes
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+// Classes
+#include "simulation/World.h"
+
+namespace
+{
+	typedef std::chrono::steady_clock Clock;
+
+	const double minimumSeconds = 0.5;
+
+	// Body steps per second of the given world
+	template <class Precision>
+	double measureThroughput(BasicWorld<Precision>& world, const float& dt)
+	{
+		world.step(dt);
+
+		std::size_t steps = 0;
+		const Clock::time_point start = Clock::now();
+		double seconds = 0.0;
+		do
+		{
+			world.step(dt);
+			++steps;
+			seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		} while (seconds < minimumSeconds);
+
+		return static_cast<double>(steps) * world.bodies().size() / seconds;
+	}
+
+	template <class Precision>
+	double measureClusterThroughput(const std::size_t& count)
+	{
+		WorldOptions options;
+		options.threadCount = 1;
+		options.integrator = LEAPFROG;
+
+		BasicWorld<Precision> world(options);
+
+		std::mt19937 generator(42);
+		std::normal_distribution<double> position(0.0, 1000.0);
+		for (std::size_t i = 0; i < count; ++i)
+			world.bodies().add(1.0e6f, 0.0f, 0.0f, glm::dvec3(position(generator), position(generator), position(generator)));
+
+		return measureThroughput(world, 0.01f);
+	}
+
+	template <class Precision>
+	double measureSurfaceThroughput(const std::size_t& count)
+	{
+		WorldOptions options;
+		options.threadCount = 1;
+		options.typeOfSpace = NEAR_AN_ASTRONOMICAL_OBJECT;
+		options.ambientDensity = 1.2f;
+		options.astronomicalObjectMass = 5.972e24f;
+		options.astronomicalObjectRadius = 6.371e6f;
+		options.astronomicalObjectAverageSoilDensity = 1500.0f;
+
+		BasicWorld<Precision> world(options);
+
+		std::mt19937 generator(42);
+		std::uniform_real_distribution<double> position(-1.0e5, 1.0e5);
+		std::uniform_real_distribution<double> height(0.0, 1.0e4);
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			world.bodies().add(1.0f, 0.5f, 0.1f, glm::dvec3(position(generator), height(generator), position(generator)));
+			world.bodies().current().velocity.setDouble(i, glm::dvec3(100.0, 50.0, 0.0));
+		}
+
+		return measureThroughput(world, 0.01f);
+	}
+
+	// Satellite on a circular orbit 1000 km above the Earth's surface, integrated for one period with
+	// 4th-order Yoshida steps. Truncation error is far below a millimetre, so what remains is rounding:
+	// of the state, and of the float force math, which bounds every policy at about a metre per orbit
+	template <class Precision>
+	void measureOrbitError(double& maxRadialError, double& closureError)
+	{
+		// As stored in the body properties
+		const double earthMass = static_cast<double>(5.972e24f);
+		const double radius = 7.371e6;
+		const double speed = std::sqrt(GRAVITATIONAL_CONSTANT * earthMass / radius);
+		const double period = 2.0 * 3.14159265358979323846 * radius / speed;
+		const float dt = 1.0f;
+		const int steps = static_cast<int>(period / dt);
+
+		WorldOptions options;
+		options.threadCount = 1;
+		options.integrator = YOSHIDA4;
+		options.softeningLength = 0.0f;
+
+		BasicWorld<Precision> world(options);
+		BasicBodyStore<Precision>& bodies = world.bodies();
+		bodies.add(static_cast<float>(earthMass), 0.0f, 0.0f, glm::dvec3(0.0));
+		bodies.add(1.0f, 0.0f, 0.0f, glm::dvec3(radius, 0.0, 0.0));
+		bodies.current().velocity.setDouble(1, glm::dvec3(0.0, 0.0, speed));
+
+		maxRadialError = 0.0;
+		for (int step = 0; step < steps; ++step)
+		{
+			world.step(dt);
+
+			const typename BasicBodyStore<Precision>::State& state = bodies.current();
+			const glm::dvec3 r(
+				difference(state.coordinates.x[1], state.coordinates.x[0]),
+				difference(state.coordinates.y[1], state.coordinates.y[0]),
+				difference(state.coordinates.z[1], state.coordinates.z[0]));
+			maxRadialError = std::max(maxRadialError, std::abs(std::sqrt(r.x * r.x + r.y * r.y + r.z * r.z) - radius));
+		}
+
+		// Position after whole steps against the exact orbit at the same time
+		const double angle = speed / radius * steps * static_cast<double>(dt);
+		const glm::dvec3 expected(radius * std::cos(angle), 0.0, radius * std::sin(angle));
+		const glm::dvec3 actual = bodies.current().coordinates.getDouble(1) - bodies.current().coordinates.getDouble(0);
+		const glm::dvec3 error = actual - expected;
+		closureError = std::sqrt(error.x * error.x + error.y * error.y + error.z * error.z);
+	}
+
+	template <class Precision>
+	void run()
+	{
+		double maxRadialError = 0.0, closureError = 0.0;
+		measureOrbitError<Precision>(maxRadialError, closureError);
+
+		std::printf("%-8s  %14.3e  %14.3e  %14.3e  %14.3e  %14.3e\n",
+			Precision::getName(),
+			measureClusterThroughput<Precision>(1024),
+			measureClusterThroughput<Precision>(4096),
+			measureSurfaceThroughput<Precision>(65536),
+			maxRadialError,
+			closureError);
+	}
+}
+
+int main()
+{
+	std::printf("%-8s  %14s  %14s  %14s  %14s  %14s\n", "", "cluster 1024", "cluster 4096", "surface 65536", "orbit radial", "orbit closure");
+	std::printf("%-8s  %14s  %14s  %14s  %14s  %14s\n", "state", "body steps/s", "body steps/s", "body steps/s", "error, m", "error, m");
+
+	run<SinglePrecision>();
+	run<DoublePrecision>();
+	run<FixedPointPrecision>();
+
+	return 0;
+}
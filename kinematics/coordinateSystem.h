@@ -39,16 +39,22 @@ struct CoordinateSystem
 
 	void draw(const Shader& shader)
 	{
+		if (shader.Program != colorProgram)
+		{
+			color = shader.getUniform<glm::vec3>("color");
+			colorProgram = shader.Program;
+		}
+
 		glLineWidth(2.0f);
 
 		glBindVertexArray(VAO);
-		shader.setVector3("color", glm::vec3(1.0f, 0.0f, 0.0f));
+		shader.set(color, glm::vec3(1.0f, 0.0f, 0.0f));
 		glDrawArrays(GL_LINE_STRIP, 0, 2);
 
-		shader.setVector3("color", glm::vec3(0.0f, 1.0f, 0.0f));
+		shader.set(color, glm::vec3(0.0f, 1.0f, 0.0f));
 		glDrawArrays(GL_LINE_STRIP, 2, 2);
 
-		shader.setVector3("color", glm::vec3(0.0f, 0.0f, 1.0f));
+		shader.set(color, glm::vec3(0.0f, 0.0f, 1.0f));
 		glDrawArrays(GL_LINE_STRIP, 4, 2);
 		glBindVertexArray(0);
 	}
@@ -60,4 +66,8 @@ struct CoordinateSystem
 	}
 
 	GLuint VAO, VBO;
+
+	// Handle of the colour uniform of the program it was resolved for
+	GLuint colorProgram = 0;
+	Uniform<glm::vec3> color;
 };
\ No newline at end of file
@@ -1,4 +1,7 @@
 // Std. Includes
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <iostream>
 #include <vector>
 
@@ -28,6 +31,16 @@
 #include "Camera.h"
 #include "CoordinateSystem.h"
 #include "MaterialPoint.h"
+#include "TrajectoryBatch.h"
+#include "ForceArrowBatch.h"
+#include "BodySpriteBatch.h"
+#include "CameraUniformBuffer.h"
+#include "Frustum.h"
+#include "simulation/World.h"
+#include "simulation/HermiteIntegrator.h"
+#include "simulation/SimulationClock.h"
+#include "simulation/SimulationThread.h"
+#include "simulation/Profiler.h"
 
 // Callback-functions
 void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mode);
@@ -50,25 +63,58 @@ GLfloat lastFrame = 0.0f;
 bool showCursor = false;
 bool theWorld = false;
 
-// Objects
-MaterialPoint* controlledObject = nullptr;
+// World: stepped on the simulation thread, which publishes snapshots of it and runs the GUI's edits as commands
+World world;
+SimulationClock simulationClock; // time step settings; the simulation thread steps with a copy
+SimulationThread simulation(world, simulationClock);
+WorldOptions worldOptions; // GUI copy of world.options, sent to the simulation whenever it is edited
+std::uint64_t appliedStep = 0; // last step whose samples are in the trajectories
+void applySnapshot();
+void setBodyProperty(const BodyHandle& body, std::vector<float> BodyProperties::* property, const float& value);
+
+// Objects (objects[i] draws world body i); bodies are referred to by handle, which survives removals and reordering
+BodyHandle controlledObject;
 std::vector<MaterialPoint> objects;
-void doObjectMovement();
+BodyNameIndex bodyNames; // unique object IDs
+void syncObjectsWithBodies(const BodyStore& bodies, std::vector<bool>& createdObjects);
+TrajectoryBatch trajectoryBatch;
+ForceArrowBatch forceArrowBatch;
+BodySpriteBatch bodySpriteBatch;
+CameraUniformBuffer cameraUniforms;
+// CPU time spent issuing the scene's GL calls, smoothed over frames, ms
+double drawSubmissionTime = 0.0;
+// Time to set up the shader programs at start-up, ms, and how many came from the binary cache
+double shaderSetupTime = 0.0;
+int cachedShaderCount = 0;
+void doObjectControl(int key, int action);
 
 // World options
-static float ambientDensity = 0.0f;
-static int typeOfSpace = EMPTY_SPACE;
 bool astronomicalObjectEditMenu = false;
-static float astronomicalObjectMass = 0.0f;
-static float astronomicalObjectRadius = 0.0f;
-static float astronomicalObjectSoilAmbientDensity = 0.0f;
+int trajectoryMemoryBudget = DEFAULT_TRAJECTORY_MEMORY_BUDGET / 1024; // KiB per object
+float trajectoryTolerance = DEFAULT_TRAJECTORY_TOLERANCE;
+float trajectoryScreenError = DEFAULT_TRAJECTORY_SCREEN_ERROR; // px
+bool drawBodies = true;
+int bodyColorMode = BODY_COLOR_BY_SPEED;
 
 // GUI Menu
 bool menuCreateObject = false;
 bool menuObjectList = false;
 bool menuWorldOptions = false;
+bool menuProfiler = false;
 void displayGUImenu();
 
+// Objects list
+#define OBJECT_COLUMN_NAME 0
+#define OBJECT_COLUMN_MASS 1
+#define OBJECT_COLUMN_SPEED 2
+#define OBJECT_COLUMN_ALTITUDE 3
+#define OBJECT_LIST_SORT_INTERVAL 0.25 // s between re-sorts by a changing column
+std::vector<std::size_t> objectListOrder; // object shown in each row of the table
+std::vector<float> objectListKeys;
+double objectListSortTime = 0.0;
+BodyHandle inspectedObject;
+void sortObjectList(ImGuiTableSortSpecs* sortSpecs);
+
 int WinMain()
 {
 	glfwInit();
@@ -110,7 +156,22 @@ int WinMain()
 
 
 	// Shader
+	const std::chrono::steady_clock::time_point shaderStart = std::chrono::steady_clock::now();
 	Shader mainShader("main.vertexShader", "main.fragmentShader");
+	Shader trajectoryShader("trajectory.vertexShader", "trajectory.fragmentShader");
+	Shader forceArrowShader("forceArrow.vertexShader", "forceArrow.fragmentShader");
+	Shader bodySpriteShader("bodySprite.vertexShader", "bodySprite.fragmentShader");
+	shaderSetupTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - shaderStart).count() * 1000.0;
+	for (const Shader* shader : { &mainShader, &trajectoryShader, &forceArrowShader, &bodySpriteShader })
+		cachedShaderCount += shader->isLoadedFromBinaryCache() ? 1 : 0;
+
+	// View and projection come from the shared camera block; every model matrix is the identity
+	for (const Shader* shader : { &mainShader, &trajectoryShader, &forceArrowShader, &bodySpriteShader })
+	{
+		shader->bindUniformBlock("Camera", CAMERA_UNIFORM_BLOCK_BINDING);
+		shader->Use();
+		shader->set(shader->getUniform<glm::mat4>("model"), glm::mat4(1.0f));
+	}
 
 	// 3D Coordinate system
 	CoordinateSystem XYZ;
@@ -118,61 +179,103 @@ int WinMain()
 	glEnable(GL_LINE_SMOOTH);
 	glLineWidth(2.0f);
 	glEnable(GL_DEPTH_TEST);
+	glEnable(GL_PROGRAM_POINT_SIZE);
 
-	//Rendering
-	GLfloat renderingDeltaTime = 0.0f;
+	simulation.start();
 
 	while (!glfwWindowShouldClose(window))
 	{
+		// Timings of the previous frames, from every thread
+		if (Profiler::isEnabled())
+			Profiler::collect();
+		PROFILE_SCOPE("Frame");
+
 		// Set frame time
 		GLfloat currentFrame = glfwGetTime();
 		deltaTime = currentFrame - lastFrame;
 		lastFrame = currentFrame;
 
-		renderingDeltaTime += deltaTime;
-
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		glfwPollEvents();
+		{
+			PROFILE_SCOPE("Events");
+			glfwPollEvents();
+		}
+
+		// Physics runs in fixed steps on its own thread; the frame shows the latest state it published
+		{
+			PROFILE_SCOPE("Snapshot");
+			if (simulation.acquire())
+				applySnapshot();
+		}
+		const WorldSnapshot& snapshot = simulation.getSnapshot();
 
 		doCameraMovement();
-		doObjectMovement();
 
 		displayGUImenu();
 
-		mainShader.Use();
-		mainShader.setMatrix4("model", glm::mat4(1.0f));
-		mainShader.setMatrix4("view", mainCamera.GetViewMatrix());
-		mainShader.setMatrix4("projection", glm::perspective(mainCamera.Zoom, (float)screenWidth / (float)screenHeight, 0.1f, 1000000.0f));
+		// Bodies are drawn between the last two physics states
+		const float interpolationFactor = snapshot.getInterpolationFactor(std::chrono::steady_clock::now());
 
-		XYZ.draw(mainShader);
+		const std::chrono::steady_clock::time_point drawStart = std::chrono::steady_clock::now();
 
-		for (int i = 0; i < objects.size(); ++i)
+		const glm::mat4 view = mainCamera.GetViewMatrix();
+		const glm::mat4 projection = glm::perspective(mainCamera.Zoom, (float)screenWidth / (float)screenHeight, 0.1f, 1000000.0f);
+		cameraUniforms.update(view, projection);
+
+		// Trajectory chunks and force vectors outside the view are not submitted
+		const Frustum frustum(projection * view);
+		// Pixels covered by one metre one metre away from the camera
+		const float pixelScale = (float)screenHeight / (2.0f * tan(mainCamera.Zoom / 2.0f));
+
+		// Every trajectory in one draw call, each chunk at the level of detail its distance allows
+		trajectoryShader.Use();
+		trajectoryBatch.setMaxScreenError(trajectoryScreenError);
+		{
+			PROFILE_SCOPE("Trajectory upload");
+			trajectoryBatch.update(objects, frustum, mainCamera.Position, pixelScale);
+		}
 		{
-			objects[i].drawTrajectory(mainShader);
-			objects[i].drawDevelopedForceVector(mainShader);
-			objects[i].drawDragForceVector(mainShader);
-			objects[i].drawGravitationalForceVector(mainShader);
+			PROFILE_SCOPE("Trajectory draw");
+			trajectoryBatch.draw();
 		}
 
-		if (renderingDeltaTime >= 0.10f)
-			renderingDeltaTime = 0.0f;
+		mainShader.Use();
+		XYZ.draw(mainShader);
 
-		if (!theWorld)
+		// Every force vector in one instanced draw call
 		{
-			if (renderingDeltaTime >= 0.01f)
-			{
-				for (int i = 0; i < objects.size(); ++i)
-					objects[i].computeInstantCharachteristics(objects, ambientDensity, renderingDeltaTime, typeOfSpace, astronomicalObjectMass, astronomicalObjectRadius, astronomicalObjectSoilAmbientDensity);
+			PROFILE_SCOPE("Force vectors");
+			forceArrowShader.Use();
+			forceArrowBatch.update(objects, snapshot.bodies, interpolationFactor, frustum);
+			forceArrowBatch.draw();
+		}
 
-				renderingDeltaTime = 0.0f;
-			}
+		// Every body as a point sprite in one draw call
+		if (drawBodies)
+		{
+			PROFILE_SCOPE("Bodies");
+			bodySpriteShader.Use();
+			bodySpriteBatch.update(snapshot.bodies, interpolationFactor, bodyColorMode);
+			bodySpriteBatch.draw(bodySpriteShader, pixelScale);
 		}
 
+		const double drawSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - drawStart).count();
+		drawSubmissionTime = 0.9 * drawSubmissionTime + 0.1 * drawSeconds * 1000.0;
+
+		PROFILE_SCOPE("Swap");
 		glfwSwapBuffers(window);
 	}
 
+	simulation.stop();
+
+	// Batch buffers are released while the context still exists
+	trajectoryBatch.release();
+	forceArrowBatch.release();
+	bodySpriteBatch.release();
+	cameraUniforms.release();
+
 	glfwTerminate();
 
 	return 0;
@@ -180,6 +283,8 @@ int WinMain()
 
 void displayGUImenu()
 {
+	PROFILE_SCOPE("GUI");
+
 	// Start the Dear ImGui frame
 	ImGui_ImplOpenGL3_NewFrame();
 	ImGui_ImplGlfw_NewFrame();
@@ -198,12 +303,15 @@ void displayGUImenu()
 			if (ImGui::MenuItem("World options"))
 				menuWorldOptions = true;
 
+			if (ImGui::MenuItem("Profiler"))
+				menuProfiler = true;
+
 			ImGui::EndMenu();
 		}
 
 		if (menuCreateObject)
 		{
-			ImGui::SetNextWindowSize({ 418.0f, 260.0f });
+			ImGui::SetNextWindowSize({ 418.0f, 284.0f });
 
 			ImGui::Begin("Object creating", NULL, ImGuiWindowFlags_NoResize);
 
@@ -253,10 +361,31 @@ void displayGUImenu()
 			static float midsection = 0.0f;
 			ImGui::DragFloat("      ", &midsection, 0.005f, ImGuiInputTextFlags_CharsScientific);
 
-			if (ImGui::Button("Create"))
+			// IDs are unique and name the object: an empty or a taken one is refused rather than made ambiguous.
+			// The ID is taken once the body shows up in a snapshot, so no second body is created before that.
+			static bool idEmpty = false;
+			static bool idTaken = false;
+			static bool creating = false;
+			if (ImGui::Button("Create") && !creating)
 			{
-				objects.push_back({ idBuffer, mass, dragCoefficient, midsection, {x, y, z} });
-				controlledObject = &objects[objects.size() - 1];
+				idEmpty = idBuffer[0] == '\0';
+				idTaken = !idEmpty && bodyNames.contains(idBuffer);
+				if (!idEmpty && !idTaken)
+				{
+					// The object itself is made once the body shows up in a snapshot
+					creating = true;
+					simulation.request([name = std::string(idBuffer), mass = mass, dragCoefficient = dragCoefficient, midsection = midsection,
+						coordinates = glm::dvec3(x, y, z)](World& simulated) -> SimulationThread::Completion
+					{
+						const BodyHandle body = simulated.bodies().add(mass, dragCoefficient, midsection, coordinates);
+						return [name, body]()
+						{
+							controlledObject = body;
+							bodyNames.insert(name, body);
+							creating = false;
+						};
+					});
+				}
 			}
 
 			ImGui::SameLine();
@@ -264,6 +393,11 @@ void displayGUImenu()
 			if (ImGui::Button("Close"))
 				menuCreateObject = false;
 
+			if (idEmpty)
+				ImGui::TextColored({ 1.0f, 0.0f, 0.0f, 1.0f }, "An object needs an ID");
+			if (idTaken)
+				ImGui::TextColored({ 1.0f, 0.0f, 0.0f, 1.0f }, "An object with ID \"%s\" exists already", idBuffer);
+
 			ImGui::End();
 		}
 		if (menuObjectList)
@@ -272,199 +406,376 @@ void displayGUImenu()
 
 			ImGui::Begin("Objects list", NULL, ImGuiWindowFlags_NoResize);
 
-			if (ImGui::TreeNode("Objects"))
+			// Looks the ID up in the name index and opens the object in the inspector
+			ImGui::Text("Find ID:");
+			ImGui::SameLine();
+			ImGui::PushItemWidth(-FLT_MIN);
+			static char findBuffer[16];
+			static bool findFailed = false;
+			if (ImGui::InputText("##find", findBuffer, IM_ARRAYSIZE(findBuffer), ImGuiInputTextFlags_EnterReturnsTrue | ImGuiInputTextFlags_CharsNoBlank))
 			{
-				for (int i = 0; i < objects.size(); ++i)
-				{
-					if (i == 0)
-						ImGui::SetNextItemOpen(true, ImGuiCond_Once);
+				const BodyHandle found = bodyNames.find(findBuffer);
+				findFailed = !simulation.getSnapshot().bodies.contains(found);
+				if (!findFailed)
+					inspectedObject = found;
+			}
+			if (findFailed)
+				ImGui::TextColored({ 1.0f, 0.0f, 0.0f, 1.0f }, "No object with ID \"%s\"", findBuffer);
 
-					if (ImGui::TreeNode((void*)(intptr_t)i, "%s", objects[i].getObjectName(), ImGuiInputTextFlags_None))
+			// Only the rows in view are formatted; a row opens its object in the inspector
+			const ImGuiTableFlags tableFlags = ImGuiTableFlags_Sortable | ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg |
+				ImGuiTableFlags_BordersOuter | ImGuiTableFlags_BordersV | ImGuiTableFlags_Resizable;
+			if (ImGui::BeginTable("Objects", 4, tableFlags))
+			{
+				ImGui::TableSetupScrollFreeze(0, 1);
+				ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_DefaultSort, 0.0f, OBJECT_COLUMN_NAME);
+				ImGui::TableSetupColumn("Mass, kg", ImGuiTableColumnFlags_None, 0.0f, OBJECT_COLUMN_MASS);
+				ImGui::TableSetupColumn("Speed, m/s", ImGuiTableColumnFlags_None, 0.0f, OBJECT_COLUMN_SPEED);
+				ImGui::TableSetupColumn("Altitude, m", ImGuiTableColumnFlags_None, 0.0f, OBJECT_COLUMN_ALTITUDE);
+				ImGui::TableHeadersRow();
+
+				sortObjectList(ImGui::TableGetSortSpecs());
+
+				const BodyStore& bodies = simulation.getSnapshot().bodies;
+				ImGuiListClipper clipper;
+				clipper.Begin((int)objectListOrder.size());
+				while (clipper.Step())
+				{
+					for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
 					{
-						ImGui::Spacing(); ImGui::Spacing(); ImGui::Spacing();
-
-						ImGui::Text("Object properties:");
-						ImGui::DragFloat("Mass, kg", &objects[i].mass, 0.005f);
-
-						ImGui::Text("Drag coefficient:%f", objects[i].getObjectDragCoefficient());
-						ImGui::DragFloat("Midsection, m^2", &objects[i].midsection, 0.005f);
-
-
-						ImGui::Text("Coordinates:");
-
-						ImGui::PushStyleColor(NULL, { 1.0f, 0.0f, 0.0f, 1.0f });
-						ImGui::Text("X:%f m", objects[i].getObjectCoordinates().x);
-						ImGui::PopStyleColor();
+						const std::size_t i = objectListOrder[row];
 
-						ImGui::PushStyleColor(NULL, { 0.0f, 1.0f, 0.0f, 1.0f });
-						ImGui::Text("Y:%f m", objects[i].getObjectCoordinates().y);
-						ImGui::PopStyleColor();
+						ImGui::PushID((int)i);
+						ImGui::TableNextRow();
 
-						ImGui::PushStyleColor(NULL, { 0.0f, 0.0f, 1.0f, 1.0f });
-						ImGui::Text("Z:%f m", objects[i].getObjectCoordinates().z);
-						ImGui::PopStyleColor();
+						ImGui::TableNextColumn();
+						if (ImGui::Selectable(bodyNames.getString(objects[i].getName()).c_str(), inspectedObject == objects[i].getBody(), ImGuiSelectableFlags_SpanAllColumns))
+							inspectedObject = objects[i].getBody();
 
-						ImGui::Spacing(); ImGui::Spacing(); ImGui::Spacing();
+						ImGui::TableNextColumn();
+						ImGui::Text("%g", bodies.mass[i]);
+						ImGui::TableNextColumn();
+						ImGui::Text("%.3f", glm::length(bodies.current().velocity.get(i)));
+						ImGui::TableNextColumn();
+						ImGui::Text("%.3f", bodies.current().coordinates.get(i).y);
 
-						ImGui::Text("Velocity (V):");
-						ImGui::Text("V:%f m/s", glm::length(objects[i].getObjectVelocityVector()));
-
-						ImGui::PushStyleColor(NULL, { 1.0f, 0.0f, 0.0f, 1.0f });
-						ImGui::Text("Vx:%f m/s", objects[i].getObjectVelocityVector().x);
-						ImGui::PopStyleColor();
-
-						ImGui::PushStyleColor(NULL, { 0.0f, 1.0f, 0.0f, 1.0f });
-						ImGui::Text("Vy:%f m/s", objects[i].getObjectVelocityVector().y);
-						ImGui::PopStyleColor();
-
-						ImGui::PushStyleColor(NULL, { 0.0f, 0.0f, 1.0f, 1.0f });
-						ImGui::Text("Vz:%f m/s", objects[i].getObjectVelocityVector().z);
-						ImGui::PopStyleColor();
+						ImGui::PopID();
+					}
+				}
+				ImGui::EndTable();
+			}
 
-						ImGui::Spacing(); ImGui::Spacing(); ImGui::Spacing();
+			ImGui::End();
+		}
+		if (simulation.getSnapshot().bodies.contains(inspectedObject))
+		{
+			ImGui::SetNextWindowSize({ 500.0f, 1010.0f }, ImGuiCond_FirstUseEver);
 
-						ImGui::Text("Acceleration (a):");
-						ImGui::Text("a:%f m/s^2", glm::length(objects[i].getObjectAccelerationVector()));
+			bool inspectorOpen = true;
+			ImGui::Begin("Object inspector", &inspectorOpen);
 
-						ImGui::PushStyleColor(NULL, { 1.0f, 0.0f, 0.0f, 1.0f });
-						ImGui::Text("ax:%f m/s^2", objects[i].getObjectAccelerationVector().x);
-						ImGui::PopStyleColor();
+			const BodyStore& bodies = simulation.getSnapshot().bodies;
+			const std::size_t i = bodies.indexOf(inspectedObject);
 
-						ImGui::PushStyleColor(NULL, { 0.0f, 1.0f, 0.0f, 1.0f });
-						ImGui::Text("ay:%f m/s^2", objects[i].getObjectAccelerationVector().y);
-						ImGui::PopStyleColor();
+			ImGui::Text("%s", bodyNames.getString(objects[i].getName()).c_str());
+			ImGui::Spacing(); ImGui::Spacing(); ImGui::Spacing();
 
-						ImGui::PushStyleColor(NULL, { 0.0f, 0.0f, 1.0f, 1.0f });
-						ImGui::Text("az:%f m/s^2", objects[i].getObjectAccelerationVector().z);
-						ImGui::PopStyleColor();
+			ImGui::Text("Object properties:");
+			float mass = bodies.mass[i];
+			if (ImGui::DragFloat("Mass, kg", &mass, 0.005f))
+				setBodyProperty(inspectedObject, &BodyProperties::mass, mass);
 
-						ImGui::Spacing(); ImGui::Spacing(); ImGui::Spacing();
+			ImGui::Text("Drag coefficient:%f", bodies.dragCoefficient[i]);
+			float midsection = bodies.midsection[i];
+			if (ImGui::DragFloat("Midsection, m^2", &midsection, 0.005f))
+				setBodyProperty(inspectedObject, &BodyProperties::midsection, midsection);
 
-						ImGui::Text("Developed Force(F):");
-						ImGui::DragFloat("N", &objects[i].forceAbsValue, 0.05f);
+			ImGui::Text("Coordinates:");
 
-						ImGui::Text("Zenith:");
-						ImGui::DragFloat("degrees", &objects[i].theta, 0.05f);
+			ImGui::TextColored({ 1.0f, 0.0f, 0.0f, 1.0f }, "X:%f m", bodies.current().coordinates.get(i).x);
+			ImGui::TextColored({ 0.0f, 1.0f, 0.0f, 1.0f }, "Y:%f m", bodies.current().coordinates.get(i).y);
+			ImGui::TextColored({ 0.0f, 0.0f, 1.0f, 1.0f }, "Z:%f m", bodies.current().coordinates.get(i).z);
 
-						ImGui::Text("Azimuth:");
-						ImGui::DragFloat("degrees ", &objects[i].ph, 0.05f);
+			ImGui::Spacing(); ImGui::Spacing(); ImGui::Spacing();
 
-						ImGui::PushStyleColor(NULL, { 1.0f, 0.0f, 0.0f, 1.0f });
-						ImGui::Text("Fx:%f N", objects[i].getObjectDevelopedForceVector().x);
-						ImGui::PopStyleColor();
+			ImGui::Text("Velocity (V):");
+			ImGui::Text("V:%f m/s", glm::length(bodies.current().velocity.get(i)));
 
-						ImGui::PushStyleColor(NULL, { 0.0f, 1.0f, 0.0f, 1.0f });
-						ImGui::Text("Fy:%f N", objects[i].getObjectDevelopedForceVector().y);
-						ImGui::PopStyleColor();
+			ImGui::TextColored({ 1.0f, 0.0f, 0.0f, 1.0f }, "Vx:%f m/s", bodies.current().velocity.get(i).x);
+			ImGui::TextColored({ 0.0f, 1.0f, 0.0f, 1.0f }, "Vy:%f m/s", bodies.current().velocity.get(i).y);
+			ImGui::TextColored({ 0.0f, 0.0f, 1.0f, 1.0f }, "Vz:%f m/s", bodies.current().velocity.get(i).z);
 
-						ImGui::PushStyleColor(NULL, { 0.0f, 0.0f, 1.0f, 1.0f });
-						ImGui::Text("Fz:%f N", objects[i].getObjectDevelopedForceVector().z);
-						ImGui::PopStyleColor();
+			ImGui::Spacing(); ImGui::Spacing(); ImGui::Spacing();
 
-						ImGui::Spacing(); ImGui::Spacing(); ImGui::Spacing();
+			ImGui::Text("Acceleration (a):");
+			ImGui::Text("a:%f m/s^2", glm::length(bodies.acceleration.get(i)));
 
-						ImGui::Text("Drag Force(Fd):");
-						ImGui::Text("Fd:%f N", glm::length(objects[i].getObjectDragForceVector()));
+			ImGui::TextColored({ 1.0f, 0.0f, 0.0f, 1.0f }, "ax:%f m/s^2", bodies.acceleration.get(i).x);
+			ImGui::TextColored({ 0.0f, 1.0f, 0.0f, 1.0f }, "ay:%f m/s^2", bodies.acceleration.get(i).y);
+			ImGui::TextColored({ 0.0f, 0.0f, 1.0f, 1.0f }, "az:%f m/s^2", bodies.acceleration.get(i).z);
 
-						ImGui::PushStyleColor(NULL, { 1.0f, 0.0f, 0.0f, 1.0f });
-						ImGui::Text("Fdx:%f N", objects[i].getObjectDragForceVector().x);
-						ImGui::PopStyleColor();
+			ImGui::Spacing(); ImGui::Spacing(); ImGui::Spacing();
 
-						ImGui::PushStyleColor(NULL, { 0.0f, 1.0f, 0.0f, 1.0f });
-						ImGui::Text("Fdy:%f N", objects[i].getObjectDragForceVector().y);
-						ImGui::PopStyleColor();
+			ImGui::Text("Developed Force(F):");
+			float forceAbsValue = bodies.forceAbsValue[i];
+			if (ImGui::DragFloat("N", &forceAbsValue, 0.05f))
+				setBodyProperty(inspectedObject, &BodyProperties::forceAbsValue, forceAbsValue);
 
-						ImGui::PushStyleColor(NULL, { 0.0f, 0.0f, 1.0f, 1.0f });
-						ImGui::Text("Fdz:%f N", objects[i].getObjectDragForceVector().z);
-						ImGui::PopStyleColor();
+			ImGui::Text("Zenith:");
+			float theta = bodies.theta[i];
+			if (ImGui::DragFloat("degrees", &theta, 0.05f))
+				setBodyProperty(inspectedObject, &BodyProperties::theta, theta);
 
-						ImGui::Spacing(); ImGui::Spacing(); ImGui::Spacing();
+			ImGui::Text("Azimuth:");
+			float ph = bodies.ph[i];
+			if (ImGui::DragFloat("degrees ", &ph, 0.05f))
+				setBodyProperty(inspectedObject, &BodyProperties::ph, ph);
 
-						ImGui::Text("Gravitational Force(Fg):");
-						ImGui::Text("Fg:%f N", glm::length(objects[i].getObjectGravitationalForceVector()));
+			ImGui::TextColored({ 1.0f, 0.0f, 0.0f, 1.0f }, "Fx:%f N", bodies.developedForce.get(i).x);
+			ImGui::TextColored({ 0.0f, 1.0f, 0.0f, 1.0f }, "Fy:%f N", bodies.developedForce.get(i).y);
+			ImGui::TextColored({ 0.0f, 0.0f, 1.0f, 1.0f }, "Fz:%f N", bodies.developedForce.get(i).z);
 
-						ImGui::PushStyleColor(NULL, { 1.0f, 0.0f, 0.0f, 1.0f });
-						ImGui::Text("Fgx:%f N", objects[i].getObjectGravitationalForceVector().x);
-						ImGui::PopStyleColor();
+			ImGui::Spacing(); ImGui::Spacing(); ImGui::Spacing();
 
-						ImGui::PushStyleColor(NULL, { 0.0f, 1.0f, 0.0f, 1.0f });
-						ImGui::Text("Fgy:%f N", objects[i].getObjectGravitationalForceVector().y);
-						ImGui::PopStyleColor();
+			ImGui::Text("Drag Force(Fd):");
+			ImGui::Text("Fd:%f N", glm::length(bodies.dragForce.get(i)));
 
-						ImGui::PushStyleColor(NULL, { 0.0f, 0.0f, 1.0f, 1.0f });
-						ImGui::Text("Fgz:%f N", objects[i].getObjectGravitationalForceVector().z);
-						ImGui::PopStyleColor();
+			ImGui::TextColored({ 1.0f, 0.0f, 0.0f, 1.0f }, "Fdx:%f N", bodies.dragForce.get(i).x);
+			ImGui::TextColored({ 0.0f, 1.0f, 0.0f, 1.0f }, "Fdy:%f N", bodies.dragForce.get(i).y);
+			ImGui::TextColored({ 0.0f, 0.0f, 1.0f, 1.0f }, "Fdz:%f N", bodies.dragForce.get(i).z);
 
-						ImGui::Text("Normal reaction Force(Fn):");
-						ImGui::Text("Fn:%f N", glm::length(objects[i].getObjectNormalReactionForceVector()));
+			ImGui::Spacing(); ImGui::Spacing(); ImGui::Spacing();
 
-						ImGui::PushStyleColor(NULL, { 1.0f, 0.0f, 0.0f, 1.0f });
-						ImGui::Text("Fnx:%f N", objects[i].getObjectNormalReactionForceVector().x);
-						ImGui::PopStyleColor();
+			ImGui::Text("Gravitational Force(Fg):");
+			ImGui::Text("Fg:%f N", glm::length(bodies.gravitationalForce.get(i)));
 
-						ImGui::PushStyleColor(NULL, { 0.0f, 1.0f, 0.0f, 1.0f });
-						ImGui::Text("Fny:%f N", objects[i].getObjectNormalReactionForceVector().y);
-						ImGui::PopStyleColor();
+			ImGui::TextColored({ 1.0f, 0.0f, 0.0f, 1.0f }, "Fgx:%f N", bodies.gravitationalForce.get(i).x);
+			ImGui::TextColored({ 0.0f, 1.0f, 0.0f, 1.0f }, "Fgy:%f N", bodies.gravitationalForce.get(i).y);
+			ImGui::TextColored({ 0.0f, 0.0f, 1.0f, 1.0f }, "Fgz:%f N", bodies.gravitationalForce.get(i).z);
 
-						ImGui::PushStyleColor(NULL, { 0.0f, 0.0f, 1.0f, 1.0f });
-						ImGui::Text("Fnz:%f N", objects[i].getObjectNormalReactionForceVector().z);
-						ImGui::PopStyleColor();
+			ImGui::Text("Normal reaction Force(Fn):");
+			ImGui::Text("Fn:%f N", glm::length(bodies.normalReactionForce.get(i)));
 
-						ImGui::Spacing(); ImGui::Spacing(); ImGui::Spacing();
+			ImGui::TextColored({ 1.0f, 0.0f, 0.0f, 1.0f }, "Fnx:%f N", bodies.normalReactionForce.get(i).x);
+			ImGui::TextColored({ 0.0f, 1.0f, 0.0f, 1.0f }, "Fny:%f N", bodies.normalReactionForce.get(i).y);
+			ImGui::TextColored({ 0.0f, 0.0f, 1.0f, 1.0f }, "Fnz:%f N", bodies.normalReactionForce.get(i).z);
 
-						ImGui::Text("Draw:");
-						ImGui::Checkbox("Trajectory", &objects[i].drawTrajectoryStatus);
-						ImGui::Checkbox("Developed Force", &objects[i].drawDevelopedForceStatus);
-						ImGui::Checkbox("Drag Force", &objects[i].drawDragForceStatus);
-						ImGui::Checkbox("Gravitational Force", &objects[i].drawGravitationalForceStatus);
+			ImGui::Spacing(); ImGui::Spacing(); ImGui::Spacing();
 
-						ImGui::Spacing(); ImGui::Spacing(); ImGui::Spacing();
+			ImGui::Text("Draw:");
+			ImGui::Checkbox("Trajectory", &objects[i].drawTrajectoryStatus);
+			ImGui::SameLine();
+			ImGui::ColorEdit3("Trajectory color", &objects[i].trajectoryColor.x, ImGuiColorEditFlags_NoInputs | ImGuiColorEditFlags_NoLabel);
+			ImGui::Checkbox("Developed Force", &objects[i].drawDevelopedForceStatus);
+			ImGui::Checkbox("Drag Force", &objects[i].drawDragForceStatus);
+			ImGui::Checkbox("Gravitational Force", &objects[i].drawGravitationalForceStatus);
+			ImGui::Checkbox("Normal reaction Force", &objects[i].drawNormalReactionForceStatus);
 
-						if (ImGui::SmallButton("Delete object"))
-							objects.erase(objects.begin() + i);
+			ImGui::Spacing(); ImGui::Spacing(); ImGui::Spacing();
 
-						ImGui::TreePop();
-					}
-				}
-				ImGui::TreePop();
+			if (ImGui::SmallButton("Delete object"))
+			{
+				// Handles held elsewhere, e.g. controlledObject, simply go stale; the object goes with the next snapshot
+				const BodyHandle body = inspectedObject;
+				simulation.post([body](World& simulated) { simulated.bodies().remove(body); });
+				inspectorOpen = false;
 			}
 
 			ImGui::End();
+
+			if (!inspectorOpen)
+				inspectedObject = BodyHandle();
 		}
 		if (menuWorldOptions)
 		{
-			ImGui::SetNextWindowSize({ 700.0f, 300.0f });
+			ImGui::SetNextWindowSize({ 700.0f, 794.0f });
 
 			ImGui::Begin("World options", NULL, ImGuiWindowFlags_NoResize);
 
+			// Edits are made to the GUI copy of the options, and the simulation takes a copy of it
+			bool optionsChanged = false;
 
-			if (ImGui::RadioButton("Empty space", &typeOfSpace, EMPTY_SPACE)) { astronomicalObjectEditMenu = false; }
-			if (ImGui::RadioButton("Near an astronomical object", &typeOfSpace, NEAR_AN_ASTRONOMICAL_OBJECT)) { astronomicalObjectEditMenu = true; }
+			if (ImGui::RadioButton("Empty space", &worldOptions.typeOfSpace, EMPTY_SPACE)) { astronomicalObjectEditMenu = false; optionsChanged = true; }
+			if (ImGui::RadioButton("Near an astronomical object", &worldOptions.typeOfSpace, NEAR_AN_ASTRONOMICAL_OBJECT)) { astronomicalObjectEditMenu = true; optionsChanged = true; }
 
 			if (astronomicalObjectEditMenu)
 			{
 				ImGui::Text("Astronomical object radius:");
 				ImGui::SameLine();
 				ImGui::PushItemWidth(-FLT_MIN);
-				ImGui::DragFloat("m", &astronomicalObjectRadius, 0.005f);
+				optionsChanged |= ImGui::DragFloat("m", &worldOptions.astronomicalObjectRadius, 0.005f);
 
 				ImGui::Text("Astronomical object mass:");
 				ImGui::SameLine();
 				ImGui::PushItemWidth(-FLT_MIN);
-				ImGui::DragFloat("kg", &astronomicalObjectMass, 0.005f);
+				optionsChanged |= ImGui::DragFloat("kg", &worldOptions.astronomicalObjectMass, 0.005f);
 
 				ImGui::Text("Astronomical object soil ambient density:");
 				ImGui::SameLine();
 				ImGui::PushItemWidth(-FLT_MIN);
-				ImGui::DragFloat("kg/m^3", &astronomicalObjectSoilAmbientDensity, 0.005f);
+				optionsChanged |= ImGui::DragFloat("kg/m^3", &worldOptions.astronomicalObjectAverageSoilDensity, 0.005f);
+			}
+			else
+			{
+				ImGui::Text("Gravity solver:");
+				optionsChanged |= ImGui::RadioButton("Direct sum", &worldOptions.gravitySolver, DIRECT_SUM);
+				ImGui::SameLine();
+				optionsChanged |= ImGui::RadioButton("Barnes-Hut", &worldOptions.gravitySolver, BARNES_HUT);
+
+				if (worldOptions.gravitySolver == DIRECT_SUM)
+				{
+					ImGui::SameLine();
+					ImGui::Text("(%s)", getSimdLevelName(selectSimdLevel(worldOptions.simdLevel)));
+				}
+
+				ImGui::Text("Softening length:");
+				ImGui::SameLine();
+				ImGui::PushItemWidth(-FLT_MIN);
+				optionsChanged |= ImGui::DragFloat(" m", &worldOptions.softeningLength, 0.001f, 0.0f, FLT_MAX, "%.4f");
+
+				if (worldOptions.gravitySolver == BARNES_HUT)
+				{
+					ImGui::Text("Opening angle:");
+					ImGui::SameLine();
+					ImGui::PushItemWidth(-FLT_MIN);
+					optionsChanged |= ImGui::SliderFloat("  ", &worldOptions.openingAngle, 0.0f, 1.5f, "%.2f");
+
+					static GravityErrorReport gravityErrorReport;
+					if (ImGui::Button("Check accuracy"))
+						gravityErrorReport = measureBarnesHutError(simulation.getSnapshot().bodies, worldOptions.openingAngle, worldOptions.softeningLength * worldOptions.softeningLength);
+
+					if (gravityErrorReport.sampledBodies > 0)
+					{
+						ImGui::Text("Relative error over %d bodies: max %.2e, mean %.2e", (int)gravityErrorReport.sampledBodies, gravityErrorReport.maxRelativeError, gravityErrorReport.meanRelativeError);
+						ImGui::Text("Direct sum: %.3f ms, Barnes-Hut: %.3f ms", gravityErrorReport.directSeconds * 1000.0, gravityErrorReport.barnesHutSeconds * 1000.0);
+					}
+				}
 			}
 
 			ImGui::Spacing(); ImGui::Spacing(); ImGui::Spacing();
 
+			ImGui::Text("Time step:");
+			ImGui::SameLine();
+			ImGui::PushItemWidth(200.0f);
+			bool clockChanged = ImGui::DragFloat(" s", &simulationClock.fixedDeltaTime, 0.0001f, 0.0001f, 1.0f, "%.4f");
+			ImGui::SameLine();
+			ImGui::Text("Max steps at once:");
+			ImGui::SameLine();
+			ImGui::PushItemWidth(-FLT_MIN);
+			clockChanged |= ImGui::SliderInt("    ", &simulationClock.maxSubsteps, 1, 64);
+			if (clockChanged)
+				simulation.setTimeStep(simulationClock.fixedDeltaTime, simulationClock.maxSubsteps);
+
+			const WorldSnapshot& snapshot = simulation.getSnapshot();
+			ImGui::Text("Simulation: %.0f steps/s, %.3f ms per step, %.2f s simulated; rendering: %.0f frames/s", snapshot.stepRate, snapshot.stepTime,
+				snapshot.simulatedTime, ImGui::GetIO().Framerate);
+
+			ImGui::Text("Integrator:");
+			ImGui::SameLine();
+			optionsChanged |= ImGui::RadioButton("Semi-implicit Euler", &worldOptions.integrator, SEMI_IMPLICIT_EULER);
+			ImGui::SameLine();
+			optionsChanged |= ImGui::RadioButton("Leapfrog", &worldOptions.integrator, LEAPFROG);
+			ImGui::SameLine();
+			optionsChanged |= ImGui::RadioButton("Velocity Verlet", &worldOptions.integrator, VELOCITY_VERLET);
+			ImGui::SameLine();
+			optionsChanged |= ImGui::RadioButton("Yoshida", &worldOptions.integrator, YOSHIDA4);
+			ImGui::SameLine();
+			optionsChanged |= ImGui::RadioButton("Hermite", &worldOptions.integrator, HERMITE_BLOCK);
+
+			if (snapshot.hermite)
+			{
+				const HermiteStatistics& statistics = snapshot.hermiteStatistics;
+				ImGui::Text("Force evaluations: %llu, shared step would need %llu (saved %llu), deepest level %d",
+					(unsigned long long)statistics.forceEvaluations, (unsigned long long)statistics.sharedStepForceEvaluations,
+					(unsigned long long)statistics.getSavedForceEvaluations(), statistics.deepestLevel);
+			}
+
+			// The pairwise potential is O(N^2), so it is only evaluated on request, between two steps
+			if (ImGui::Button("Measure energy"))
+				simulation.measureEnergy();
+			ImGui::SameLine();
+			if (snapshot.energyMeasured)
+				ImGui::Text("Total energy: %.6e J after step %llu", snapshot.totalEnergy, (unsigned long long)snapshot.energyStep);
+			else
+				ImGui::Text("Total energy: not measured");
+
+			ImGui::Text("Simulation threads:");
+			ImGui::SameLine();
+			ImGui::PushItemWidth(-FLT_MIN);
+			int threadCount = (int)worldOptions.threadCount;
+			if (ImGui::SliderInt("   ", &threadCount, 1, 2 * (int)ThreadPool::getHardwareThreadCount()))
+			{
+				worldOptions.threadCount = (unsigned int)threadCount;
+				optionsChanged = true;
+			}
+
 			ImGui::Text("Ambient density:");
 			ImGui::SameLine();
 			ImGui::PushItemWidth(-FLT_MIN);
-			ImGui::InputFloat(" kg/m^3", &ambientDensity, 0.1f, 0.1f, "%.3f", ImGuiInputTextFlags_CharsScientific);
+			optionsChanged |= ImGui::InputFloat(" kg/m^3", &worldOptions.ambientDensity, 0.1f, 0.1f, "%.3f", ImGuiInputTextFlags_CharsScientific);
+
+			if (optionsChanged)
+			{
+				const WorldOptions options = worldOptions;
+				simulation.post([options](World& simulated) { simulated.options = options; });
+			}
+
+			ImGui::Text("Trajectory memory per object:");
+			ImGui::SameLine();
+			ImGui::PushItemWidth(200.0f);
+			bool trajectorySettingsChanged = ImGui::SliderInt("      ", &trajectoryMemoryBudget, 1, 4096, "%d KiB");
+			ImGui::SameLine();
+			ImGui::Text("Tolerance:");
+			ImGui::SameLine();
+			ImGui::PushItemWidth(-FLT_MIN);
+			trajectorySettingsChanged |= ImGui::DragFloat("  m", &trajectoryTolerance, 0.001f, 0.0f, FLT_MAX, "%.3f");
+
+			std::size_t trajectoryMemory = 0, trajectoryPoints = 0, archivedPoints = 0;
+			float archiveTolerance = 0.0f;
+			for (std::size_t i = 0; i < objects.size(); ++i)
+			{
+				Trajectory& trajectory = objects[i].getTrajectory();
+				if (trajectorySettingsChanged)
+				{
+					trajectory.setMemoryBudget(trajectoryMemoryBudget * 1024);
+					trajectory.setTolerance(trajectoryTolerance);
+				}
+
+				trajectoryMemory += trajectory.getMemoryUsage();
+				trajectoryPoints += trajectory.getPointCount();
+				archivedPoints += trajectory.getArchivedPointCount();
+				if (trajectory.getArchivedPointCount() > 0)
+					archiveTolerance = std::max(archiveTolerance, trajectory.getArchiveTolerance());
+			}
+			ImGui::Text("Trajectories: %.1f KiB, %llu points (%llu simplified, within %.3f m)", trajectoryMemory / 1024.0,
+				(unsigned long long)trajectoryPoints, (unsigned long long)archivedPoints, archiveTolerance);
+			ImGui::Text("Trajectory detail: at most");
+			ImGui::SameLine();
+			ImGui::PushItemWidth(200.0f);
+			ImGui::SliderFloat("  px off the full polyline", &trajectoryScreenError, 0.0f, 8.0f, "%.2f");
+			ImGui::Text("Trajectory buffer: %.1f KiB, %llu bytes uploaded last frame, %llu chunks in one draw call", trajectoryBatch.getCapacity() / 1024.0,
+				(unsigned long long)trajectoryBatch.getLastUploadSize(), (unsigned long long)trajectoryBatch.getDrawCount());
+			ImGui::Text("Trajectory vertices: %llu drawn for %llu visible, %llu culled", (unsigned long long)trajectoryBatch.getDrawnVertexCount(),
+				(unsigned long long)trajectoryBatch.getVisibleVertexCount(), (unsigned long long)trajectoryBatch.getCulledVertexCount());
+			ImGui::Text("Force vectors: %llu in one draw call, %llu culled", (unsigned long long)forceArrowBatch.getArrowCount(), (unsigned long long)forceArrowBatch.getCulledArrowCount());
+			ImGui::Text("Draw submission: %.3f ms (CPU)", drawSubmissionTime);
+			ImGui::Text("Shader programs: %.1f ms at start-up, %d of 4 from the binary cache", shaderSetupTime, cachedShaderCount);
+
+			ImGui::Checkbox("Draw bodies", &drawBodies);
+			ImGui::SameLine();
+			ImGui::Text("colored by");
+			ImGui::SameLine();
+			ImGui::RadioButton("speed", &bodyColorMode, BODY_COLOR_BY_SPEED);
+			ImGui::SameLine();
+			ImGui::RadioButton("mass", &bodyColorMode, BODY_COLOR_BY_MASS);
+			if (drawBodies)
+			{
+				ImGui::SameLine();
+				if (bodyColorMode == BODY_COLOR_BY_MASS)
+					ImGui::Text("(blue %.3g kg, red %.3g kg)", pow(10.0, bodySpriteBatch.getColorMin()), pow(10.0, bodySpriteBatch.getColorMax()));
+				else
+					ImGui::Text("(blue %.3g m/s, red %.3g m/s)", bodySpriteBatch.getColorMin(), bodySpriteBatch.getColorMax());
+			}
 
 			if (ImGui::Button("Close"))
 				menuWorldOptions = false;
@@ -472,6 +783,54 @@ void displayGUImenu()
 			ImGui::End();
 		}
 
+		// Timers only record while the profiler is shown
+		Profiler::setEnabled(menuProfiler);
+		if (menuProfiler)
+		{
+			ImGui::SetNextWindowSize({ 640.0f, 470.0f });
+
+			ImGui::Begin("Profiler", NULL, ImGuiWindowFlags_NoResize);
+
+			const std::vector<ProfileStage>& stages = Profiler::getStages();
+			for (const ProfileStage& stage : stages)
+			{
+				if (std::strcmp(stage.name, "Frame") == 0)
+					ImGui::Text("Frame time: p50 %.2f ms, p99 %.2f ms over the last %d frames", stage.p50, stage.p99, (int)stage.history.size());
+			}
+
+			// Stages of the simulation thread run at its own pace, so they may take more or less than one call per frame
+			if (ImGui::BeginTable("Stages", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersOuter | ImGuiTableFlags_BordersV))
+			{
+				ImGui::TableSetupColumn("Stage");
+				ImGui::TableSetupColumn("ms/frame");
+				ImGui::TableSetupColumn("calls/frame");
+				ImGui::TableSetupColumn("p50, ms");
+				ImGui::TableSetupColumn("p99, ms");
+				ImGui::TableHeadersRow();
+
+				for (const ProfileStage& stage : stages)
+				{
+					ImGui::TableNextRow();
+					ImGui::TableNextColumn();
+					ImGui::Text("%s", stage.name);
+					ImGui::TableNextColumn();
+					ImGui::Text("%.3f", stage.millisecondsPerFrame);
+					ImGui::TableNextColumn();
+					ImGui::Text("%.2f", stage.callsPerFrame);
+					ImGui::TableNextColumn();
+					ImGui::Text("%.3f", stage.p50);
+					ImGui::TableNextColumn();
+					ImGui::Text("%.3f", stage.p99);
+				}
+				ImGui::EndTable();
+			}
+
+			if (ImGui::Button("Close"))
+				menuProfiler = false;
+
+			ImGui::End();
+		}
+
 		ImGui::EndMainMenuBar();
 	}
 
@@ -480,24 +839,169 @@ void displayGUImenu()
 	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 }
 
-// Object controls
-void doObjectMovement()
+// Keeps objectListOrder a permutation of the objects in the order of the table's sort column. Names are sorted
+// when the sort or the objects change; speed, altitude and mass change on their own, so rows sorted by them are
+// also re-sorted every OBJECT_LIST_SORT_INTERVAL, while the values shown stay live.
+void sortObjectList(ImGuiTableSortSpecs* sortSpecs)
+{
+	const std::size_t count = objects.size();
+	if (objectListOrder.size() != count)
+	{
+		objectListOrder.resize(count);
+		for (std::size_t i = 0; i < count; ++i)
+			objectListOrder[i] = i;
+		if (sortSpecs != NULL)
+			sortSpecs->SpecsDirty = true;
+	}
+
+	if (sortSpecs == NULL || sortSpecs->SpecsCount == 0)
+		return;
+
+	const ImGuiTableColumnSortSpecs& sortSpec = sortSpecs->Specs[0];
+	const bool ascending = sortSpec.SortDirection != ImGuiSortDirection_Descending;
+
+	if (sortSpec.ColumnUserID == OBJECT_COLUMN_NAME)
+	{
+		if (!sortSpecs->SpecsDirty)
+			return;
+
+		std::sort(objectListOrder.begin(), objectListOrder.end(), [ascending](const std::size_t& a, const std::size_t& b)
+		{
+			const int order = bodyNames.getString(objects[a].getName()).compare(bodyNames.getString(objects[b].getName()));
+			return order != 0 ? (ascending ? order < 0 : order > 0) : a < b;
+		});
+	}
+	else
+	{
+		if (!sortSpecs->SpecsDirty && ImGui::GetTime() - objectListSortTime < OBJECT_LIST_SORT_INTERVAL)
+			return;
+
+		const BodyStore& bodies = simulation.getSnapshot().bodies;
+		objectListKeys.resize(count);
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			if (sortSpec.ColumnUserID == OBJECT_COLUMN_MASS)
+				objectListKeys[i] = bodies.mass[i];
+			else if (sortSpec.ColumnUserID == OBJECT_COLUMN_SPEED)
+				objectListKeys[i] = glm::length(bodies.current().velocity.get(i));
+			else
+				objectListKeys[i] = bodies.current().coordinates.get(i).y;
+		}
+
+		std::sort(objectListOrder.begin(), objectListOrder.end(), [ascending](const std::size_t& a, const std::size_t& b)
+		{
+			if (objectListKeys[a] != objectListKeys[b])
+				return ascending ? objectListKeys[a] < objectListKeys[b] : objectListKeys[a] > objectListKeys[b];
+			return a < b;
+		});
+		objectListSortTime = ImGui::GetTime();
+	}
+
+	sortSpecs->SpecsDirty = false;
+}
+
+// Takes over a new snapshot: brings the objects in line with its bodies and extends the trajectories by the steps taken since the last one
+void applySnapshot()
 {
-	if (controlledObject != nullptr)
+	const WorldSnapshot& snapshot = simulation.getSnapshot();
+
+	static std::vector<bool> createdObjects;
+	syncObjectsWithBodies(snapshot.bodies, createdObjects);
+
+	// A new object starts its trajectory where the body is now
+	for (const TrajectorySample& sample : snapshot.samples)
 	{
-		if (keys[GLFW_KEY_UP])
-			(*controlledObject).ProcessKeyboardObject(RAISE_DEVELOPED_FORCE_VECTOR, deltaTime);
-		if (keys[GLFW_KEY_DOWN])
-			(*controlledObject).ProcessKeyboardObject(LOWER_DEVELOPED_FORCE_VECTOR, deltaTime);
-		if (keys[GLFW_KEY_LEFT])
-			(*controlledObject).ProcessKeyboardObject(TURN_LEFT_DEVELOPED_FORCE_VECTOR, deltaTime);
-		if (keys[GLFW_KEY_RIGHT])
-			(*controlledObject).ProcessKeyboardObject(TURN_RIGHT_DEVELOPED_FORCE_VECTOR, deltaTime);
-		if (keys[GLFW_KEY_E])
-			(*controlledObject).ProcessKeyboardObject(INCREASE_DEVELOPED_FORCE_VECTOR, deltaTime);
-		if (keys[GLFW_KEY_Q])
-			(*controlledObject).ProcessKeyboardObject(DECREASE_DEVELOPED_FORCE_VECTOR, deltaTime);
+		if (sample.step <= appliedStep)
+			continue;
+
+		const std::size_t i = snapshot.bodies.indexOf(sample.body);
+		if (i != NO_INDEX && !createdObjects[i])
+			objects[i].updateTrajectoryCoordinates(sample.coordinates);
 	}
+	appliedStep = snapshot.steps;
+}
+
+// Drops the objects of removed bodies, makes objects for new ones and puts them all in the order of the bodies
+void syncObjectsWithBodies(const BodyStore& bodies, std::vector<bool>& createdObjects)
+{
+	createdObjects.assign(bodies.size(), false);
+
+	bool inOrder = objects.size() == bodies.size();
+	for (std::size_t i = 0; inOrder && i < objects.size(); ++i)
+		inOrder = objects[i].getBody() == bodies.getHandle(i);
+	if (inOrder)
+		return;
+
+	std::vector<std::size_t> objectOfBody(bodies.size(), NO_INDEX);
+	for (std::size_t j = 0; j < objects.size(); ++j)
+	{
+		const std::size_t body = bodies.indexOf(objects[j].getBody());
+		if (body != NO_INDEX)
+			objectOfBody[body] = j;
+		else
+			bodyNames.erase(objects[j].getBody());
+	}
+
+	std::vector<MaterialPoint> ordered;
+	ordered.reserve(bodies.size());
+	for (std::size_t i = 0; i < bodies.size(); ++i)
+	{
+		if (objectOfBody[i] != NO_INDEX)
+		{
+			ordered.push_back(std::move(objects[objectOfBody[i]]));
+			continue;
+		}
+
+		// Bodies are named when they are created, before the simulation has run the command
+		const BodyHandle body = bodies.getHandle(i);
+		const NameId name = bodyNames.getName(body);
+		ordered.push_back({ name != NO_NAME ? name : bodyNames.getNames().intern(""), body, bodies.current().coordinates.get(i) });
+		ordered.back().getTrajectory().setMemoryBudget(trajectoryMemoryBudget * 1024);
+		ordered.back().getTrajectory().setTolerance(trajectoryTolerance);
+		createdObjects[i] = true;
+	}
+	objects.swap(ordered);
+}
+
+// Queues a change of one property of a body; it shows in the snapshots once the simulation has run it
+void setBodyProperty(const BodyHandle& body, std::vector<float> BodyProperties::* property, const float& value)
+{
+	simulation.post([body, property, value](World& simulated)
+	{
+		const std::size_t i = simulated.bodies().indexOf(body);
+		if (i != NO_INDEX)
+		{
+			(simulated.bodies().*property)[i] = value;
+			simulated.bodies().markEdited();
+		}
+	});
+}
+
+// Object controls
+// Presses and releases of the force vector keys go to the simulation as they happen, with the time they happened,
+// so a control is applied for as long as it was held whatever the frame rate
+void doObjectControl(int key, int action)
+{
+	if (action != GLFW_PRESS && action != GLFW_RELEASE)
+		return;
+
+	forceVector control;
+	if (key == GLFW_KEY_UP)
+		control = RAISE_DEVELOPED_FORCE_VECTOR;
+	else if (key == GLFW_KEY_DOWN)
+		control = LOWER_DEVELOPED_FORCE_VECTOR;
+	else if (key == GLFW_KEY_LEFT)
+		control = TURN_LEFT_DEVELOPED_FORCE_VECTOR;
+	else if (key == GLFW_KEY_RIGHT)
+		control = TURN_RIGHT_DEVELOPED_FORCE_VECTOR;
+	else if (key == GLFW_KEY_E)
+		control = INCREASE_DEVELOPED_FORCE_VECTOR;
+	else if (key == GLFW_KEY_Q)
+		control = DECREASE_DEVELOPED_FORCE_VECTOR;
+	else
+		return;
+
+	simulation.pushControl({ std::chrono::steady_clock::now(), controlledObject, control, action == GLFW_PRESS });
 }
 
 // Camera controls
@@ -551,8 +1055,12 @@ void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mode
 			theWorld = false;
 
 		else theWorld = true;
+
+		simulation.setPaused(theWorld);
 	}
 
+	doObjectControl(key, action);
+
 	if (key >= 0 && key < 1024)
 	{
 		if (action == GLFW_PRESS)
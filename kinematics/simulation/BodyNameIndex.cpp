@@ -0,0 +1,57 @@
+#include "BodyNameIndex.h"
+
+NameId NameTable::intern(const std::string& name)
+{
+	const std::pair<std::unordered_map<std::string, NameId>::iterator, bool> inserted = ids.emplace(name, static_cast<NameId>(strings.size()));
+	if (inserted.second)
+		strings.push_back(&inserted.first->first);
+	return inserted.first->second;
+}
+
+NameId NameTable::find(const std::string& name) const
+{
+	const std::unordered_map<std::string, NameId>::const_iterator id = ids.find(name);
+	return id != ids.end() ? id->second : NO_NAME;
+}
+
+bool BodyNameIndex::insert(const std::string& name, const BodyHandle& body)
+{
+	if (contains(name) || getName(body) != NO_NAME)
+		return false;
+
+	const NameId id = names.intern(name);
+	if (id >= bodyOfName.size())
+		bodyOfName.resize(id + 1);
+	if (body.slot >= nameOfSlot.size())
+		nameOfSlot.resize(body.slot + 1, NO_NAME);
+
+	bodyOfName[id] = body;
+	nameOfSlot[body.slot] = id;
+	return true;
+}
+
+void BodyNameIndex::erase(const BodyHandle& body)
+{
+	const NameId id = getName(body);
+	if (id == NO_NAME)
+		return;
+
+	bodyOfName[id] = BodyHandle();
+	nameOfSlot[body.slot] = NO_NAME;
+}
+
+BodyHandle BodyNameIndex::find(const std::string& name) const
+{
+	const NameId id = names.find(name);
+	return id < bodyOfName.size() ? bodyOfName[id] : BodyHandle();
+}
+
+NameId BodyNameIndex::getName(const BodyHandle& body) const
+{
+	if (body.slot >= nameOfSlot.size())
+		return NO_NAME;
+
+	// The slot may have been named by an older body that is gone
+	const NameId id = nameOfSlot[body.slot];
+	return id != NO_NAME && bodyOfName[id] == body ? id : NO_NAME;
+}
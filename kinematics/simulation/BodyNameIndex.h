@@ -0,0 +1,59 @@
+#pragma once
+
+// Std. Includes
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Classes
+#include "BodyStore.h"
+
+typedef std::uint32_t NameId;
+
+#define NO_NAME 0xFFFFFFFFu
+
+// String table: every distinct string is stored once and known by a small integer from then on
+class NameTable
+{
+public:
+	// Id of name, adding it if it is new
+	NameId intern(const std::string& name);
+	// NO_NAME if name was never interned
+	NameId find(const std::string& name) const;
+
+	const std::string& getString(const NameId& name) const { return *strings[name]; }
+	std::size_t size() const { return strings.size(); }
+
+private:
+	std::unordered_map<std::string, NameId> ids;
+	// Keys of ids, which stay where they are as the map grows
+	std::vector<const std::string*> strings;
+};
+
+// Unique body names: an O(1) index from name to body handle, and from body to its interned name.
+// Names are only looked up here, by the GUI and by scripts; the physics loops never see them.
+class BodyNameIndex
+{
+public:
+	// Names body, unless the name is taken by another body already; a body has one name at most
+	bool insert(const std::string& name, const BodyHandle& body);
+	// Frees the name of a removed body
+	void erase(const BodyHandle& body);
+
+	// Handle of the body with the name; a null handle if there is none
+	BodyHandle find(const std::string& name) const;
+	bool contains(const std::string& name) const { return find(name) != BodyHandle(); }
+	// NO_NAME for a body without a name
+	NameId getName(const BodyHandle& body) const;
+
+	const std::string& getString(const NameId& name) const { return names.getString(name); }
+	NameTable& getNames() { return names; }
+
+private:
+	NameTable names;
+
+	// Indexed by NameId, and by the slot of the body handle
+	std::vector<BodyHandle> bodyOfName;
+	std::vector<NameId> nameOfSlot;
+};
@@ -0,0 +1,183 @@
+#include "BodyStore.h"
+
+void BodyProperties::addProperties(const float& mass, const float& dragCoefficient, const float& midsection)
+{
+	markEdited();
+
+	acceleration.push_back(glm::dvec3(0.0));
+
+	this->mass.push_back(mass);
+	this->dragCoefficient.push_back(dragCoefficient);
+	this->midsection.push_back(midsection);
+
+	forceAbsValue.push_back(0.0f);
+	theta.push_back(0.0f);
+	ph.push_back(0.0f);
+
+	developedForce.push_back(glm::dvec3(0.0));
+	dragForce.push_back(glm::dvec3(0.0));
+	gravitationalForce.push_back(glm::dvec3(0.0));
+	normalReactionForce.push_back(glm::dvec3(0.0));
+}
+
+namespace
+{
+	template <class T>
+	void swapRemove(std::vector<T>& values, const std::size_t& i)
+	{
+		values[i] = values.back();
+		values.pop_back();
+	}
+}
+
+void BodyProperties::removeProperties(const std::size_t& body)
+{
+	markEdited();
+
+	acceleration.swapRemove(body);
+
+	swapRemove(mass, body);
+	swapRemove(dragCoefficient, body);
+	swapRemove(midsection, body);
+
+	swapRemove(forceAbsValue, body);
+	swapRemove(theta, body);
+	swapRemove(ph, body);
+
+	developedForce.swapRemove(body);
+	dragForce.swapRemove(body);
+	gravitationalForce.swapRemove(body);
+	normalReactionForce.swapRemove(body);
+}
+
+void BodyProperties::permuteProperties(const std::vector<std::size_t>& order)
+{
+	markEdited();
+
+	acceleration.permute(order);
+
+	permuteArray(mass, order);
+	permuteArray(dragCoefficient, order);
+	permuteArray(midsection, order);
+
+	permuteArray(forceAbsValue, order);
+	permuteArray(theta, order);
+	permuteArray(ph, order);
+
+	developedForce.permute(order);
+	dragForce.permute(order);
+	gravitationalForce.permute(order);
+	normalReactionForce.permute(order);
+}
+
+void BodyProperties::clearProperties()
+{
+	markEdited();
+
+	acceleration.clear();
+
+	mass.clear();
+	dragCoefficient.clear();
+	midsection.clear();
+
+	forceAbsValue.clear();
+	theta.clear();
+	ph.clear();
+
+	developedForce.clear();
+	dragForce.clear();
+	gravitationalForce.clear();
+	normalReactionForce.clear();
+}
+
+void BodyProperties::processKeyboardObject(const std::size_t& body, forceVector key, float deltaTime)
+{
+	float deltaForce = DEVELOPED_FORCE_RATE * deltaTime;
+	float deltaAngle = DEVELOPED_FORCE_ANGLE_RATE * deltaTime;
+
+	if (key == RAISE_DEVELOPED_FORCE_VECTOR)
+		theta[body] += deltaAngle;
+	if (key == LOWER_DEVELOPED_FORCE_VECTOR)
+		theta[body] -= deltaAngle;
+	if (key == TURN_LEFT_DEVELOPED_FORCE_VECTOR)
+		ph[body] += deltaAngle;
+	if (key == TURN_RIGHT_DEVELOPED_FORCE_VECTOR)
+		ph[body] -= deltaAngle;
+
+	if (key == INCREASE_DEVELOPED_FORCE_VECTOR)
+		forceAbsValue[body] += deltaForce;
+	if (key == DECREASE_DEVELOPED_FORCE_VECTOR)
+	{
+		forceAbsValue[body] -= deltaForce;
+
+		if (forceAbsValue[body] <= 0.0f)
+			forceAbsValue[body] = 0.0f;
+	}
+}
+
+template <class Precision>
+BodyHandle BasicBodyStore<Precision>::add(
+	const float& mass,
+	const float& dragCoefficient,
+	const float& midsection,
+	const glm::dvec3& coordinates)
+{
+	for (State& state : states)
+	{
+		state.coordinates.push_back(coordinates);
+		state.velocity.push_back(glm::dvec3(0.0));
+	}
+	addProperties(mass, dragCoefficient, midsection);
+
+	return handles.insert();
+}
+
+template <class Precision>
+void BasicBodyStore<Precision>::remove(const BodyHandle& body)
+{
+	const std::size_t index = handles.erase(body);
+	if (index == NO_INDEX)
+		return;
+
+	for (State& state : states)
+	{
+		state.coordinates.swapRemove(index);
+		state.velocity.swapRemove(index);
+	}
+	removeProperties(index);
+}
+
+template <class Precision>
+void BasicBodyStore<Precision>::remove(const std::vector<BodyHandle>& bodies)
+{
+	for (const BodyHandle& body : bodies)
+		remove(body);
+}
+
+template <class Precision>
+void BasicBodyStore<Precision>::reorder(const std::vector<std::size_t>& order)
+{
+	handles.permute(order);
+	for (State& state : states)
+	{
+		state.coordinates.permute(order);
+		state.velocity.permute(order);
+	}
+	permuteProperties(order);
+}
+
+template <class Precision>
+void BasicBodyStore<Precision>::clear()
+{
+	for (State& state : states)
+	{
+		state.coordinates.clear();
+		state.velocity.clear();
+	}
+	clearProperties();
+	handles.clear();
+}
+
+template class BasicBodyStore<SinglePrecision>;
+template class BasicBodyStore<DoublePrecision>;
+template class BasicBodyStore<FixedPointPrecision>;
@@ -0,0 +1,223 @@
+#pragma once
+
+// Std. Includes
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// GLM
+#include <glm/glm/vec3.hpp>
+
+// Classes
+#include "Precision.h"
+#include "SlotMap.h"
+
+// Force vector control
+enum forceVector {
+	RAISE_DEVELOPED_FORCE_VECTOR,
+	LOWER_DEVELOPED_FORCE_VECTOR,
+	TURN_LEFT_DEVELOPED_FORCE_VECTOR,
+	TURN_RIGHT_DEVELOPED_FORCE_VECTOR,
+	INCREASE_DEVELOPED_FORCE_VECTOR,
+	DECREASE_DEVELOPED_FORCE_VECTOR
+};
+
+// Rates the force vector controls change it at while held
+#define DEVELOPED_FORCE_ANGLE_RATE 60.0f // degrees per second
+#define DEVELOPED_FORCE_RATE 60.0f // N per second
+
+// Element k of values becomes the one that was at order[k]
+template <class T>
+void permuteArray(std::vector<T>& values, const std::vector<std::size_t>& order)
+{
+	std::vector<T> permuted(order.size());
+	for (std::size_t k = 0; k < order.size(); ++k)
+		permuted[k] = values[order[k]];
+	values.swap(permuted);
+}
+
+// Three contiguous component arrays holding one vector per body
+template <class Scalar>
+struct BasicVector3Array
+{
+	// Single-precision view of a vector, for force math and rendering
+	glm::vec3 get(std::size_t i) const { return glm::vec3(toFloat(x[i]), toFloat(y[i]), toFloat(z[i])); }
+	void set(std::size_t i, const glm::vec3& vector)
+	{
+		x[i] = fromDouble<Scalar>(vector.x);
+		y[i] = fromDouble<Scalar>(vector.y);
+		z[i] = fromDouble<Scalar>(vector.z);
+	}
+
+	// Full-precision access
+	glm::dvec3 getDouble(std::size_t i) const { return glm::dvec3(toDouble(x[i]), toDouble(y[i]), toDouble(z[i])); }
+	void setDouble(std::size_t i, const glm::dvec3& vector)
+	{
+		x[i] = fromDouble<Scalar>(vector.x);
+		y[i] = fromDouble<Scalar>(vector.y);
+		z[i] = fromDouble<Scalar>(vector.z);
+	}
+	// Moves vector i by the displacement in the stored precision
+	void displace(std::size_t i, const glm::dvec3& displacement)
+	{
+		x[i] = ::displace(x[i], displacement.x);
+		y[i] = ::displace(y[i], displacement.y);
+		z[i] = ::displace(z[i], displacement.z);
+	}
+
+	void push_back(const glm::dvec3& vector)
+	{
+		x.push_back(fromDouble<Scalar>(vector.x));
+		y.push_back(fromDouble<Scalar>(vector.y));
+		z.push_back(fromDouble<Scalar>(vector.z));
+	}
+	// Moves the last vector into i and drops the last
+	void swapRemove(std::size_t i)
+	{
+		x[i] = x.back();
+		y[i] = y.back();
+		z[i] = z.back();
+		x.pop_back();
+		y.pop_back();
+		z.pop_back();
+	}
+	// Vector k becomes the one that was at order[k]
+	void permute(const std::vector<std::size_t>& order)
+	{
+		permuteArray(x, order);
+		permuteArray(y, order);
+		permuteArray(z, order);
+	}
+	void clear()
+	{
+		x.clear();
+		y.clear();
+		z.clear();
+	}
+	void resize(std::size_t size)
+	{
+		x.resize(size);
+		y.resize(size);
+		z.resize(size);
+	}
+
+	std::vector<Scalar> x, y, z;
+};
+
+typedef BasicVector3Array<float> Vector3Array;
+
+// Kinematic state of all bodies at one instant, in the precision of the policy
+template <class Precision>
+struct BasicBodyState
+{
+	BasicVector3Array<typename Precision::Position> coordinates;
+	BasicVector3Array<typename Precision::Velocity> velocity;
+};
+
+typedef BasicBodyState<SinglePrecision> BodyState;
+
+// Per-body data that stays float whatever the precision of the state.
+// Body i is the i-th element of every array, so the physics loops only stream the properties they actually read.
+class BodyProperties
+{
+public:
+	std::size_t size() const { return mass.size(); }
+
+	// Object control-function: applies the control as held for deltaTime seconds.
+	// Leaves the revision alone: it only turns the developed force, which the next force evaluation picks up.
+	void processKeyboardObject(const std::size_t& body, forceVector key, float deltaTime);
+
+	// Changes with every edit the integrators do not make themselves: bodies added, removed or reordered, and
+	// properties or state written from outside. Integrators carry forces over from one step to the next only
+	// while it stays the same, so whoever writes to the arrays directly has to call markEdited().
+	// Controls are the exception, as they are applied before every step while a key is held: restarting the
+	// integrators for them would undo the carried-over forces for as long as anyone steers.
+	std::uint64_t getRevision() const { return revision; }
+	void markEdited() { ++revision; }
+
+public:
+	// Kinematics
+	Vector3Array acceleration;
+
+	// Object properties
+	std::vector<float> mass;
+	std::vector<float> dragCoefficient;
+	std::vector<float> midsection;
+
+	// Developed force control: absolute value and zenith/azimuth angles in degrees
+	std::vector<float> forceAbsValue;
+	std::vector<float> theta;
+	std::vector<float> ph;
+
+	// Forces applied during the last step
+	Vector3Array developedForce;
+	Vector3Array dragForce;
+	Vector3Array gravitationalForce;
+	Vector3Array normalReactionForce;
+
+protected:
+	void addProperties(const float& mass, const float& dragCoefficient, const float& midsection);
+	void removeProperties(const std::size_t& body);
+	void permuteProperties(const std::vector<std::size_t>& order);
+	void clearProperties();
+
+private:
+	std::uint64_t revision = 0;
+};
+
+// Stable reference to a body; indices change whenever bodies are removed or reordered
+typedef SlotHandle BodyHandle;
+
+// Structure-of-arrays storage of all simulated bodies: the properties plus the state in the policy's precision.
+// The arrays stay dense, so loops run over indices 0 .. size() - 1 with no holes, and bodies are referred to from
+// outside by handles. Removing a body moves the last one into its place, and reorder() may sort the bodies,
+// e.g. for locality; both keep every other handle valid.
+template <class Precision>
+class BasicBodyStore : public BodyProperties
+{
+public:
+	typedef BasicBodyState<Precision> State;
+
+	// The new body takes index size() - 1
+	BodyHandle add(
+		const float& mass,
+		const float& dragCoefficient,
+		const float& midsection,
+		const glm::dvec3& coordinates
+	);
+	// O(1): the last body takes the index of the removed one. Stale handles are ignored.
+	void remove(const BodyHandle& body);
+	void remove(const std::vector<BodyHandle>& bodies);
+	// Body k becomes the one that was at order[k]; order must be a permutation of 0 .. size() - 1
+	void reorder(const std::vector<std::size_t>& order);
+	void clear();
+
+	bool contains(const BodyHandle& body) const { return handles.contains(body); }
+	// NO_INDEX for a removed body
+	std::size_t indexOf(const BodyHandle& body) const { return handles.indexOf(body); }
+	BodyHandle getHandle(const std::size_t& body) const { return handles.handleOf(body); }
+
+	// Double-buffered state: a step reads current() (step n) and writes next() (step n + 1),
+	// then swapStates() makes the written buffer current. The old one stays readable as previous().
+	const State& current() const { return states[currentState]; }
+	State& current() { return states[currentState]; }
+	const State& previous() const { return states[1 - currentState]; }
+	State& next() { return states[1 - currentState]; }
+	void swapStates() { currentState = 1 - currentState; }
+
+	// Coordinates between the previous (alpha = 0) and the current (alpha = 1) state
+	glm::vec3 getInterpolatedCoordinates(const std::size_t& body, const float& alpha) const
+	{
+		const glm::dvec3 from = previous().coordinates.getDouble(body);
+		const glm::dvec3 to = current().coordinates.getDouble(body);
+		return glm::vec3(from + static_cast<double>(alpha) * (to - from));
+	}
+
+private:
+	State states[2];
+	int currentState = 0;
+
+	SlotMap handles;
+};
+
+typedef BasicBodyStore<SinglePrecision> BodyStore;
@@ -0,0 +1,18 @@
+#include "ForceModels.h"
+
+template <class Precision>
+BasicForceModel<Precision> selectForceModel(const WorldOptions& options)
+{
+	if (options.typeOfSpace == NEAR_AN_ASTRONOMICAL_OBJECT)
+		return applyForceModels<Precision, UniformPlanetGravity, QuadraticDrag<LayeredMedium>, GroundContact, Thrust>;
+
+	// Vacuum: no drag term at all
+	if (options.ambientDensity == 0.0f)
+		return applyForceModels<Precision, MutualGravity, Thrust>;
+
+	return applyForceModels<Precision, MutualGravity, QuadraticDrag<AmbientMedium>, Thrust>;
+}
+
+template BasicForceModel<SinglePrecision> selectForceModel<SinglePrecision>(const WorldOptions& options);
+template BasicForceModel<DoublePrecision> selectForceModel<DoublePrecision>(const WorldOptions& options);
+template BasicForceModel<FixedPointPrecision> selectForceModel<FixedPointPrecision>(const WorldOptions& options);
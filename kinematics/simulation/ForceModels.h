@@ -0,0 +1,138 @@
+#pragma once
+
+// Std. Includes
+#include <cmath>
+
+// GLM
+#include <glm/glm/geometric.hpp>
+#include <glm/glm/trigonometric.hpp>
+
+// Classes
+#include "World.h"
+
+// Everything a force model may read about one body
+struct ForceInput
+{
+	const BodyProperties& bodies;
+	const WorldOptions& options;
+	std::size_t body;
+
+	glm::vec3 coordinates;
+	glm::vec3 velocity;
+	float mass;
+};
+
+// Forces acting on one body, sorted into the categories BodyStore keeps
+struct ForceOutput
+{
+	glm::vec3 developedForce = glm::vec3(0.0f);
+	glm::vec3 dragForce = glm::vec3(0.0f);
+	glm::vec3 gravitationalForce = glm::vec3(0.0f);
+	glm::vec3 normalReactionForce = glm::vec3(0.0f);
+};
+
+// Force models. Each one is a policy with a static apply(input, output) that adds its force to the output;
+// a world configuration is a list of them, see applyForceModels().
+
+// Mutual gravity of the bodies, summed beforehand by World::computeGravitationalForces()
+struct MutualGravity
+{
+	static void apply(const ForceInput& in, ForceOutput& out)
+	{
+		out.gravitationalForce += in.bodies.gravitationalForce.get(in.body);
+	}
+};
+
+// Gravity of the astronomical object below the plane y = 0: F = G * m * M / (R + y)^2, pointing down
+struct UniformPlanetGravity
+{
+	static void apply(const ForceInput& in, ForceOutput& out)
+	{
+		const float distance = in.options.astronomicalObjectRadius + in.coordinates.y;
+		out.gravitationalForce.y -= GRAVITATIONAL_CONSTANT * in.mass * in.options.astronomicalObjectMass / (distance * distance);
+	}
+};
+
+// Medium of the quadratic drag: the ambient one everywhere
+struct AmbientMedium
+{
+	static float getDensity(const ForceInput& in) { return in.options.ambientDensity; }
+};
+
+// Medium of the quadratic drag: soil below the surface of the astronomical object, ambient above it
+struct LayeredMedium
+{
+	static float getDensity(const ForceInput& in)
+	{
+		return in.coordinates.y < 0.0f ? in.options.astronomicalObjectAverageSoilDensity : in.options.ambientDensity;
+	}
+};
+
+// F = -v / |v| * Cd * rho * |v|^2 / 2 * S, written as -v * |v| so a body at rest needs no special case
+template <class Medium>
+struct QuadraticDrag
+{
+	static void apply(const ForceInput& in, ForceOutput& out)
+	{
+		const float speed = glm::length(in.velocity);
+		out.dragForce -= in.velocity * (speed * in.bodies.dragCoefficient[in.body] * Medium::getDensity(in) / 2 * in.bodies.midsection[in.body]);
+	}
+};
+
+// Below the surface the normal reaction cancels the surface gravity G * m * M / R^2
+struct GroundContact
+{
+	static void apply(const ForceInput& in, ForceOutput& out)
+	{
+		const float R = in.options.astronomicalObjectRadius;
+		const float belowSurface = in.coordinates.y < 0.0f ? 1.0f : 0.0f;
+		out.normalReactionForce.y += belowSurface * in.mass * GRAVITATIONAL_CONSTANT * in.options.astronomicalObjectMass / (R * R);
+	}
+};
+
+// Developed force of absolute value F at zenith angle theta and azimuth ph, both in degrees
+struct Thrust
+{
+	static void apply(const ForceInput& in, ForceOutput& out)
+	{
+		const float force = in.bodies.forceAbsValue[in.body];
+		if (force == 0.0f)
+			return;
+
+		const float theta = glm::radians(in.bodies.theta[in.body]);
+		const float ph = glm::radians(in.bodies.ph[in.body]);
+		// Fx = F * cos(theta) * sin(ph)
+		out.developedForce.x += force * std::cos(theta) * std::sin(ph);
+		// Fy = F * sin(theta)
+		out.developedForce.y += force * std::sin(theta);
+		// Fz = F * cos(theta) * cos(ph)
+		out.developedForce.z += force * std::cos(theta) * std::cos(ph);
+	}
+};
+
+// Sums the force models over bodies [begin, end) of the state and writes bodies().acceleration and the force arrays.
+// Every world configuration gets its own instantiation, so the loop carries no mode branches.
+template <class Precision, class... Models>
+void applyForceModels(BasicWorld<Precision>& world, const BasicBodyState<Precision>& state, std::size_t begin, std::size_t end)
+{
+	BodyProperties& b = world.bodies();
+
+	for (std::size_t i = begin; i < end; ++i)
+	{
+		const ForceInput in = { b, world.options, i, state.coordinates.get(i), state.velocity.get(i), b.mass[i] };
+		ForceOutput out;
+
+		(Models::apply(in, out), ...);
+
+		b.acceleration.set(i, (out.developedForce + out.dragForce + out.gravitationalForce + out.normalReactionForce) / in.mass);
+
+		b.developedForce.set(i, out.developedForce);
+		b.dragForce.set(i, out.dragForce);
+		b.gravitationalForce.set(i, out.gravitationalForce);
+		b.normalReactionForce.set(i, out.normalReactionForce);
+	}
+}
+
+// Instantiation matching the options
+template <class Precision>
+BasicForceModel<Precision> selectForceModel(const WorldOptions& options);
@@ -0,0 +1,30 @@
+#include "Gravity.h"
+
+// Std. Includes
+#include <cmath>
+
+glm::vec3 directGravitationalAcceleration(
+	const BodyStore& bodies,
+	const glm::vec3& point,
+	const std::size_t& skipBody,
+	const float& softeningSquared)
+{
+	glm::vec3 acceleration(0.0f);
+
+	for (std::size_t other = 0; other < bodies.size(); ++other)
+	{
+		if (other == skipBody)
+			continue;
+
+		const glm::vec3 r = bodies.current().coordinates.get(other) - point;
+		const float distanceSquared = r.x * r.x + r.y * r.y + r.z * r.z + softeningSquared;
+
+		if (distanceSquared == 0.0f)
+			continue;
+
+		const float distance = std::sqrt(distanceSquared);
+		acceleration += bodies.mass[other] / (distanceSquared * distance) * r;
+	}
+
+	return GRAVITATIONAL_CONSTANT * acceleration;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+// Classes
+#include "BodyStore.h"
+
+#define GRAVITATIONAL_CONSTANT 6.6743e-11f
+
+// Gravitational acceleration at the given point produced by every body except skipBody,
+// summed directly over all pairs: a = G * sum(m_j * r_j / (|r_j|^2 + softening^2)^(3/2)).
+// Plain scalar reference the faster solvers are checked against.
+glm::vec3 directGravitationalAcceleration(
+	const BodyStore& bodies,
+	const glm::vec3& point,
+	const std::size_t& skipBody,
+	const float& softeningSquared = 0.0f
+);
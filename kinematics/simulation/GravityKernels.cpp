@@ -0,0 +1,123 @@
+#include "GravityKernels.h"
+
+// Classes
+#include "Gravity.h"
+
+#ifdef KINEMATICS_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+void gravityKernelScalar(const GravitySources& sources, std::size_t begin, std::size_t end, float softeningSquared, float* ax, float* ay, float* az)
+{
+	for (std::size_t i = begin; i < end; ++i)
+	{
+		float accelerationX = 0.0f, accelerationY = 0.0f, accelerationZ = 0.0f;
+		accumulateGravityScalar(sources, 0, sources.x[i], sources.y[i], sources.z[i], softeningSquared, accelerationX, accelerationY, accelerationZ);
+
+		ax[i - begin] = GRAVITATIONAL_CONSTANT * accelerationX;
+		ay[i - begin] = GRAVITATIONAL_CONSTANT * accelerationY;
+		az[i - begin] = GRAVITATIONAL_CONSTANT * accelerationZ;
+	}
+}
+
+#ifdef KINEMATICS_X86
+namespace
+{
+	void cpuid(int leaf, int subleaf, unsigned int registers[4])
+	{
+#if defined(_MSC_VER)
+		int values[4];
+		__cpuidex(values, leaf, subleaf);
+		for (int i = 0; i < 4; ++i)
+			registers[i] = static_cast<unsigned int>(values[i]);
+#else
+		__cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+	}
+
+	// Register state the OS saves on context switches (XCR0)
+	unsigned long long xgetbv()
+	{
+#if defined(_MSC_VER)
+		return _xgetbv(0);
+#else
+		unsigned int eax, edx;
+		__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+		return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+	}
+}
+#endif
+
+SimdLevel detectSimdLevel()
+{
+#ifdef KINEMATICS_X86
+	unsigned int registers[4];
+
+	cpuid(0, 0, registers);
+	const unsigned int maxLeaf = registers[0];
+
+	cpuid(1, 0, registers);
+	const bool sse2 = (registers[3] & (1u << 26)) != 0;
+	const bool fma = (registers[2] & (1u << 12)) != 0;
+	const bool osxsave = (registers[2] & (1u << 27)) != 0;
+	const bool avx = (registers[2] & (1u << 28)) != 0;
+
+	if (!sse2)
+		return SIMD_SCALAR;
+	if (!osxsave || !avx || maxLeaf < 7)
+		return SIMD_SSE;
+
+	const unsigned long long xcr0 = xgetbv();
+	// XMM and YMM state
+	if ((xcr0 & 0x6) != 0x6)
+		return SIMD_SSE;
+
+	cpuid(7, 0, registers);
+	const bool avx2 = (registers[1] & (1u << 5)) != 0;
+	const bool avx512f = (registers[1] & (1u << 16)) != 0;
+
+	if (!avx2 || !fma)
+		return SIMD_SSE;
+
+	// Opmask and ZMM state
+	if (avx512f && (xcr0 & 0xE6) == 0xE6)
+		return SIMD_AVX512;
+
+	return SIMD_AVX2;
+#else
+	return SIMD_SCALAR;
+#endif
+}
+
+const char* getSimdLevelName(const SimdLevel& level)
+{
+	switch (level)
+	{
+	case SIMD_SSE: return "SSE";
+	case SIMD_AVX2: return "AVX2";
+	case SIMD_AVX512: return "AVX-512";
+	default: return "Scalar";
+	}
+}
+
+SimdLevel selectSimdLevel(const SimdLevel& requested)
+{
+	static const SimdLevel supported = detectSimdLevel();
+	return requested < supported ? requested : supported;
+}
+
+GravityKernel getGravityKernel(const SimdLevel& level)
+{
+	switch (selectSimdLevel(level))
+	{
+	case SIMD_SSE: return gravityKernelSSE;
+	case SIMD_AVX2: return gravityKernelAVX2;
+	case SIMD_AVX512: return gravityKernelAVX512;
+	default: return gravityKernelScalar;
+	}
+}
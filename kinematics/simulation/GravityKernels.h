@@ -0,0 +1,81 @@
+#pragma once
+
+// Std. Includes
+#include <cmath>
+#include <cstddef>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define KINEMATICS_X86
+#endif
+
+// Instruction sets the direct-sum kernel is built for, in increasing order
+enum SimdLevel {
+	SIMD_SCALAR,
+	SIMD_SSE,
+	SIMD_AVX2,
+	SIMD_AVX512
+};
+
+// Packed source arrays of the direct sum: one float per body in each array
+struct GravitySources
+{
+	const float* x;
+	const float* y;
+	const float* z;
+	const float* mass;
+	std::size_t count;
+};
+
+// Writes the gravitational acceleration of targets [begin, end) (bodies of the same sources) into ax/ay/az[i - begin].
+// a_i = G * sum(m_j * r_ij / (|r_ij|^2 + softening^2)^(3/2)); a body's own term vanishes because r_ii = 0,
+// and coincident pairs with zero softening are masked out instead of producing NaN.
+typedef void (*GravityKernel)(
+	const GravitySources& sources,
+	std::size_t begin,
+	std::size_t end,
+	float softeningSquared,
+	float* ax,
+	float* ay,
+	float* az
+);
+
+void gravityKernelScalar(const GravitySources& sources, std::size_t begin, std::size_t end, float softeningSquared, float* ax, float* ay, float* az);
+void gravityKernelSSE(const GravitySources& sources, std::size_t begin, std::size_t end, float softeningSquared, float* ax, float* ay, float* az);
+void gravityKernelAVX2(const GravitySources& sources, std::size_t begin, std::size_t end, float softeningSquared, float* ax, float* ay, float* az);
+void gravityKernelAVX512(const GravitySources& sources, std::size_t begin, std::size_t end, float softeningSquared, float* ax, float* ay, float* az);
+
+// Best level supported by both this build and the running CPU/OS
+SimdLevel detectSimdLevel();
+// Requested level clamped to the supported one
+SimdLevel selectSimdLevel(const SimdLevel& requested);
+const char* getSimdLevelName(const SimdLevel& level);
+
+// Kernel for the given level, falling back to the best supported one below it
+GravityKernel getGravityKernel(const SimdLevel& level);
+
+// Remainder of a vectorized loop: sources [first, count) against one target
+inline void accumulateGravityScalar(
+	const GravitySources& sources,
+	std::size_t first,
+	float xi, float yi, float zi,
+	float softeningSquared,
+	float& ax, float& ay, float& az)
+{
+	for (std::size_t j = first; j < sources.count; ++j)
+	{
+		const float dx = sources.x[j] - xi;
+		const float dy = sources.y[j] - yi;
+		const float dz = sources.z[j] - zi;
+		const float distanceSquared = dx * dx + dy * dy + dz * dz + softeningSquared;
+
+		if (distanceSquared == 0.0f)
+			continue;
+
+		const float inverseDistance = 1.0f / std::sqrt(distanceSquared);
+		const float weight = sources.mass[j] * inverseDistance * inverseDistance * inverseDistance;
+
+		ax += weight * dx;
+		ay += weight * dy;
+		az += weight * dz;
+	}
+}
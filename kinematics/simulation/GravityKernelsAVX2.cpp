@@ -0,0 +1,76 @@
+// Built with AVX2 and FMA enabled; only called when detectSimdLevel() reports them
+#include "GravityKernels.h"
+
+// Classes
+#include "Gravity.h"
+
+#ifdef KINEMATICS_X86
+#include <immintrin.h>
+
+namespace
+{
+	float horizontalSum(__m256 vector)
+	{
+		__m128 sums = _mm_add_ps(_mm256_castps256_ps128(vector), _mm256_extractf128_ps(vector, 1));
+		__m128 shuffled = _mm_movehdup_ps(sums);
+		sums = _mm_add_ps(sums, shuffled);
+		shuffled = _mm_movehl_ps(shuffled, sums);
+		sums = _mm_add_ss(sums, shuffled);
+		return _mm_cvtss_f32(sums);
+	}
+}
+
+void gravityKernelAVX2(const GravitySources& sources, std::size_t begin, std::size_t end, float softeningSquared, float* ax, float* ay, float* az)
+{
+	const std::size_t vectorCount = sources.count & ~static_cast<std::size_t>(7);
+
+	const __m256 softening = _mm256_set1_ps(softeningSquared);
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 half = _mm256_set1_ps(0.5f);
+	const __m256 threeHalves = _mm256_set1_ps(1.5f);
+
+	for (std::size_t i = begin; i < end; ++i)
+	{
+		const __m256 xi = _mm256_set1_ps(sources.x[i]);
+		const __m256 yi = _mm256_set1_ps(sources.y[i]);
+		const __m256 zi = _mm256_set1_ps(sources.z[i]);
+
+		__m256 accelerationX = zero, accelerationY = zero, accelerationZ = zero;
+
+		for (std::size_t j = 0; j < vectorCount; j += 8)
+		{
+			const __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(sources.x + j), xi);
+			const __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(sources.y + j), yi);
+			const __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(sources.z + j), zi);
+
+			const __m256 distanceSquared = _mm256_fmadd_ps(dx, dx, _mm256_fmadd_ps(dy, dy, _mm256_fmadd_ps(dz, dz, softening)));
+
+			// 1/sqrt estimate refined by one Newton-Raphson step
+			__m256 inverseDistance = _mm256_rsqrt_ps(distanceSquared);
+			inverseDistance = _mm256_mul_ps(inverseDistance, _mm256_fnmadd_ps(_mm256_mul_ps(half, distanceSquared), _mm256_mul_ps(inverseDistance, inverseDistance), threeHalves));
+
+			__m256 weight = _mm256_mul_ps(_mm256_mul_ps(inverseDistance, inverseDistance), inverseDistance);
+			weight = _mm256_and_ps(weight, _mm256_cmp_ps(distanceSquared, zero, _CMP_GT_OQ));
+			weight = _mm256_mul_ps(weight, _mm256_loadu_ps(sources.mass + j));
+
+			accelerationX = _mm256_fmadd_ps(weight, dx, accelerationX);
+			accelerationY = _mm256_fmadd_ps(weight, dy, accelerationY);
+			accelerationZ = _mm256_fmadd_ps(weight, dz, accelerationZ);
+		}
+
+		float sumX = horizontalSum(accelerationX);
+		float sumY = horizontalSum(accelerationY);
+		float sumZ = horizontalSum(accelerationZ);
+		accumulateGravityScalar(sources, vectorCount, sources.x[i], sources.y[i], sources.z[i], softeningSquared, sumX, sumY, sumZ);
+
+		ax[i - begin] = GRAVITATIONAL_CONSTANT * sumX;
+		ay[i - begin] = GRAVITATIONAL_CONSTANT * sumY;
+		az[i - begin] = GRAVITATIONAL_CONSTANT * sumZ;
+	}
+}
+#else
+void gravityKernelAVX2(const GravitySources& sources, std::size_t begin, std::size_t end, float softeningSquared, float* ax, float* ay, float* az)
+{
+	gravityKernelScalar(sources, begin, end, softeningSquared, ax, ay, az);
+}
+#endif
@@ -0,0 +1,79 @@
+// Built with AVX-512F enabled; only called when detectSimdLevel() reports it
+#include "GravityKernels.h"
+
+// Classes
+#include "Gravity.h"
+
+#ifdef KINEMATICS_X86
+#include <immintrin.h>
+
+namespace
+{
+	// _mm512_reduce_add_ps, and the unmasked _mm512_rsqrt14_ps, pass an undefined register to a masked builtin,
+	// which GCC reports as possibly uninitialized; their masked forms take a zeroed one instead
+	float horizontalSum(__m512 vector)
+	{
+		const __m512d halves = _mm512_castps_pd(vector);
+		const __m256 sum = _mm256_add_ps(_mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xFF, halves, 0)), _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xFF, halves, 1)));
+
+		__m128 sums = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+		__m128 shuffled = _mm_movehdup_ps(sums);
+		sums = _mm_add_ps(sums, shuffled);
+		shuffled = _mm_movehl_ps(shuffled, sums);
+		sums = _mm_add_ss(sums, shuffled);
+		return _mm_cvtss_f32(sums);
+	}
+}
+
+void gravityKernelAVX512(const GravitySources& sources, std::size_t begin, std::size_t end, float softeningSquared, float* ax, float* ay, float* az)
+{
+	const __m512 softening = _mm512_set1_ps(softeningSquared);
+	const __m512 zero = _mm512_setzero_ps();
+	const __m512 half = _mm512_set1_ps(0.5f);
+	const __m512 threeHalves = _mm512_set1_ps(1.5f);
+
+	for (std::size_t i = begin; i < end; ++i)
+	{
+		const __m512 xi = _mm512_set1_ps(sources.x[i]);
+		const __m512 yi = _mm512_set1_ps(sources.y[i]);
+		const __m512 zi = _mm512_set1_ps(sources.z[i]);
+
+		__m512 accelerationX = zero, accelerationY = zero, accelerationZ = zero;
+
+		for (std::size_t j = 0; j < sources.count; j += 16)
+		{
+			// The remainder is loaded under a mask: missing lanes get zero mass and add nothing
+			const std::size_t remaining = sources.count - j;
+			const __mmask16 lanes = remaining >= 16 ? static_cast<__mmask16>(0xFFFF) : static_cast<__mmask16>((1u << remaining) - 1);
+
+			const __m512 dx = _mm512_sub_ps(_mm512_maskz_loadu_ps(lanes, sources.x + j), xi);
+			const __m512 dy = _mm512_sub_ps(_mm512_maskz_loadu_ps(lanes, sources.y + j), yi);
+			const __m512 dz = _mm512_sub_ps(_mm512_maskz_loadu_ps(lanes, sources.z + j), zi);
+			const __m512 mass = _mm512_maskz_loadu_ps(lanes, sources.mass + j);
+
+			const __m512 distanceSquared = _mm512_fmadd_ps(dx, dx, _mm512_fmadd_ps(dy, dy, _mm512_fmadd_ps(dz, dz, softening)));
+			const __mmask16 nonZero = _mm512_mask_cmp_ps_mask(lanes, distanceSquared, zero, _CMP_GT_OQ);
+
+			// 1/sqrt estimate (14 bits) refined by one Newton-Raphson step
+			__m512 inverseDistance = _mm512_maskz_rsqrt14_ps(0xFFFF, distanceSquared);
+			inverseDistance = _mm512_mul_ps(inverseDistance, _mm512_fnmadd_ps(_mm512_mul_ps(half, distanceSquared), _mm512_mul_ps(inverseDistance, inverseDistance), threeHalves));
+
+			__m512 weight = _mm512_mul_ps(_mm512_mul_ps(inverseDistance, inverseDistance), inverseDistance);
+			weight = _mm512_maskz_mul_ps(nonZero, weight, mass);
+
+			accelerationX = _mm512_fmadd_ps(weight, dx, accelerationX);
+			accelerationY = _mm512_fmadd_ps(weight, dy, accelerationY);
+			accelerationZ = _mm512_fmadd_ps(weight, dz, accelerationZ);
+		}
+
+		ax[i - begin] = GRAVITATIONAL_CONSTANT * horizontalSum(accelerationX);
+		ay[i - begin] = GRAVITATIONAL_CONSTANT * horizontalSum(accelerationY);
+		az[i - begin] = GRAVITATIONAL_CONSTANT * horizontalSum(accelerationZ);
+	}
+}
+#else
+void gravityKernelAVX512(const GravitySources& sources, std::size_t begin, std::size_t end, float softeningSquared, float* ax, float* ay, float* az)
+{
+	gravityKernelScalar(sources, begin, end, softeningSquared, ax, ay, az);
+}
+#endif
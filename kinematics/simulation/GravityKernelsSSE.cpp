@@ -0,0 +1,75 @@
+// Built with SSE2, the x86 baseline
+#include "GravityKernels.h"
+
+// Classes
+#include "Gravity.h"
+
+#ifdef KINEMATICS_X86
+#include <emmintrin.h>
+
+namespace
+{
+	float horizontalSum(__m128 vector)
+	{
+		__m128 shuffled = _mm_shuffle_ps(vector, vector, _MM_SHUFFLE(2, 3, 0, 1));
+		__m128 sums = _mm_add_ps(vector, shuffled);
+		shuffled = _mm_movehl_ps(shuffled, sums);
+		sums = _mm_add_ss(sums, shuffled);
+		return _mm_cvtss_f32(sums);
+	}
+}
+
+void gravityKernelSSE(const GravitySources& sources, std::size_t begin, std::size_t end, float softeningSquared, float* ax, float* ay, float* az)
+{
+	const std::size_t vectorCount = sources.count & ~static_cast<std::size_t>(3);
+
+	const __m128 softening = _mm_set1_ps(softeningSquared);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128 threeHalves = _mm_set1_ps(1.5f);
+
+	for (std::size_t i = begin; i < end; ++i)
+	{
+		const __m128 xi = _mm_set1_ps(sources.x[i]);
+		const __m128 yi = _mm_set1_ps(sources.y[i]);
+		const __m128 zi = _mm_set1_ps(sources.z[i]);
+
+		__m128 accelerationX = zero, accelerationY = zero, accelerationZ = zero;
+
+		for (std::size_t j = 0; j < vectorCount; j += 4)
+		{
+			const __m128 dx = _mm_sub_ps(_mm_loadu_ps(sources.x + j), xi);
+			const __m128 dy = _mm_sub_ps(_mm_loadu_ps(sources.y + j), yi);
+			const __m128 dz = _mm_sub_ps(_mm_loadu_ps(sources.z + j), zi);
+
+			const __m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_add_ps(_mm_mul_ps(dz, dz), softening));
+
+			// 1/sqrt estimate refined by one Newton-Raphson step
+			__m128 inverseDistance = _mm_rsqrt_ps(distanceSquared);
+			inverseDistance = _mm_mul_ps(inverseDistance, _mm_sub_ps(threeHalves, _mm_mul_ps(_mm_mul_ps(half, distanceSquared), _mm_mul_ps(inverseDistance, inverseDistance))));
+
+			__m128 weight = _mm_mul_ps(_mm_mul_ps(inverseDistance, inverseDistance), inverseDistance);
+			weight = _mm_and_ps(weight, _mm_cmpgt_ps(distanceSquared, zero));
+			weight = _mm_mul_ps(weight, _mm_loadu_ps(sources.mass + j));
+
+			accelerationX = _mm_add_ps(accelerationX, _mm_mul_ps(weight, dx));
+			accelerationY = _mm_add_ps(accelerationY, _mm_mul_ps(weight, dy));
+			accelerationZ = _mm_add_ps(accelerationZ, _mm_mul_ps(weight, dz));
+		}
+
+		float sumX = horizontalSum(accelerationX);
+		float sumY = horizontalSum(accelerationY);
+		float sumZ = horizontalSum(accelerationZ);
+		accumulateGravityScalar(sources, vectorCount, sources.x[i], sources.y[i], sources.z[i], softeningSquared, sumX, sumY, sumZ);
+
+		ax[i - begin] = GRAVITATIONAL_CONSTANT * sumX;
+		ay[i - begin] = GRAVITATIONAL_CONSTANT * sumY;
+		az[i - begin] = GRAVITATIONAL_CONSTANT * sumZ;
+	}
+}
+#else
+void gravityKernelSSE(const GravitySources& sources, std::size_t begin, std::size_t end, float softeningSquared, float* ax, float* ay, float* az)
+{
+	gravityKernelScalar(sources, begin, end, softeningSquared, ax, ay, az);
+}
+#endif
@@ -0,0 +1,260 @@
+#include "HermiteIntegrator.h"
+
+// Std. Includes
+#include <algorithm>
+#include <cmath>
+
+// GLM
+#include <glm/glm/geometric.hpp>
+
+// Classes
+#include "Profiler.h"
+
+namespace
+{
+	// result[i] = base[i] + displacement in the precision of the arrays
+	template <class Scalar>
+	void setDisplaced(BasicVector3Array<Scalar>& result, const BasicVector3Array<Scalar>& base, const std::size_t& i, const glm::dvec3& displacement)
+	{
+		result.x[i] = displace(base.x[i], displacement.x);
+		result.y[i] = displace(base.y[i], displacement.y);
+		result.z[i] = displace(base.z[i], displacement.z);
+	}
+}
+
+template <class Precision>
+void BasicHermiteIntegrator<Precision>::step(BasicWorld<Precision>& world, const float& dt)
+{
+	BasicBodyStore<Precision>& b = world.bodies();
+	const std::size_t count = b.size();
+
+	if (count == 0 || dt <= 0.0f)
+	{
+		bodyTime.clear();
+		return;
+	}
+
+	maxLevel = std::min(std::max(maxLevel, 0), 40);
+
+	// Start over whenever the bodies or the step were changed from outside
+	if (!keptAccelerations.isValid(b) || count != bodyTime.size() || dt != baseTimestep)
+		initialize(world, dt);
+
+	const std::uint64_t ticksPerStep = std::uint64_t(1) << maxLevel;
+	const double tick = static_cast<double>(dt) / ticksPerStep;
+
+	for (int& bodyLevel : level)
+		bodyLevel = std::min(bodyLevel, maxLevel);
+
+	int deepestLevel = *std::max_element(level.begin(), level.end());
+	std::fill(bodyTime.begin(), bodyTime.end(), std::uint64_t(0));
+
+	std::uint64_t time = 0;
+	while (time < ticksPerStep)
+	{
+		// The next block time and the bodies due at it
+		std::uint64_t blockTime = ticksPerStep;
+		for (std::size_t i = 0; i < count; ++i)
+			blockTime = std::min(blockTime, bodyTime[i] + (ticksPerStep >> level[i]));
+
+		active.clear();
+		for (std::size_t i = 0; i < count; ++i)
+			if (bodyTime[i] + (ticksPerStep >> level[i]) == blockTime)
+				active.push_back(i);
+
+		// Predictor: x + v*t + a*t^2/2 + j*t^3/6, v + a*t + j*t^2/2
+		world.parallelForBodies([&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				const double t = (blockTime - bodyTime[i]) * tick;
+				const glm::dvec3 v = state.velocity.getDouble(i);
+				const glm::dvec3 a = glm::dvec3(acceleration.get(i));
+				const glm::dvec3 j = glm::dvec3(jerk.get(i));
+
+				setDisplaced(predicted.coordinates, state.coordinates, i, t * (v + t * (a / 2.0 + t * j / 6.0)));
+				predicted.velocity.setDouble(i, v + t * (a + t * j / 2.0));
+			}
+		});
+
+		evaluate(world, active);
+
+		// Corrector and the new step of every active body
+		world.parallelFor(active.size(), [&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t k = begin; k < end; ++k)
+			{
+				const std::size_t i = active[k];
+				const double h = (ticksPerStep >> level[i]) * tick;
+
+				const glm::dvec3 v0 = state.velocity.getDouble(i);
+				const glm::dvec3 a0 = glm::dvec3(acceleration.get(i));
+				const glm::dvec3 j0 = glm::dvec3(jerk.get(i));
+				const glm::dvec3 a1 = glm::dvec3(newAcceleration.get(i));
+				const glm::dvec3 j1 = glm::dvec3(newJerk.get(i));
+
+				const glm::dvec3 v1 = v0 + (a0 + a1) * (h / 2.0) + (j0 - j1) * (h * h / 12.0);
+
+				state.coordinates.displace(i, (v0 + v1) * (h / 2.0) + (a0 - a1) * (h * h / 12.0));
+				state.velocity.setDouble(i, v1);
+				acceleration.set(i, glm::vec3(a1));
+				jerk.set(i, glm::vec3(j1));
+				bodyTime[i] = blockTime;
+
+				// Second and third derivatives from the Hermite interpolant, the second one moved to the end of the step
+				const glm::dvec3 snap0 = (-6.0 * (a0 - a1) - h * (4.0 * j0 + 2.0 * j1)) / (h * h);
+				const glm::dvec3 crackle = (12.0 * (a0 - a1) + 6.0 * h * (j0 + j1)) / (h * h * h);
+				const glm::dvec3 snap1 = snap0 + h * crackle;
+
+				// Aarseth criterion
+				const double a = glm::length(a1);
+				const double j = glm::length(j1);
+				const double s = glm::length(snap1);
+				const double c = glm::length(crackle);
+				const double denominator = j * c + s * s;
+				const float timestep = denominator > 0.0 ? static_cast<float>(std::sqrt(accuracy * (a * s + j * j) / denominator)) : dt;
+
+				int newLevel = selectLevel(dt, timestep);
+				// Shorter steps are always aligned; a longer one only where the block time is a multiple of it, one level at a time
+				if (newLevel < level[i])
+				{
+					const std::uint64_t longerStep = ticksPerStep >> (level[i] - 1);
+					newLevel = blockTime % longerStep == 0 ? level[i] - 1 : level[i];
+				}
+				level[i] = newLevel;
+			}
+		});
+
+		statistics.forceEvaluations += active.size();
+		++statistics.substeps;
+
+		deepestLevel = std::max(deepestLevel, *std::max_element(level.begin(), level.end()));
+		time = blockTime;
+	}
+
+	statistics.deepestLevel = deepestLevel;
+	statistics.sharedStepForceEvaluations += static_cast<std::uint64_t>(count) << deepestLevel;
+
+	// Every body has arrived at the end of the base step
+	BasicBodyState<Precision>& next = b.next();
+	next.coordinates = state.coordinates;
+	next.velocity = state.velocity;
+	keptAccelerations.keep(b);
+}
+
+template <class Precision>
+void BasicHermiteIntegrator<Precision>::evaluate(BasicWorld<Precision>& world, const std::vector<std::size_t>& bodies)
+{
+	PROFILE_SCOPE("Forces");
+
+	BodyProperties& b = world.bodies();
+	const std::size_t count = b.size();
+	const bool mutualGravity = world.options.typeOfSpace == EMPTY_SPACE;
+	const double softeningSquared = static_cast<double>(world.options.softeningLength) * world.options.softeningLength;
+
+	const auto& x = predicted.coordinates;
+	const auto& v = predicted.velocity;
+
+	world.parallelFor(bodies.size(), [&](std::size_t begin, std::size_t end)
+	{
+		for (std::size_t k = begin; k < end; ++k)
+		{
+			const std::size_t i = bodies[k];
+
+			double a[3] = { 0.0, 0.0, 0.0 };
+			double j[3] = { 0.0, 0.0, 0.0 };
+
+			if (mutualGravity)
+			{
+				// a = G*m*r/|r|^3, j = G*m*(v - 3*(r.v)*r/|r|^2)/|r|^3, both softened
+				for (std::size_t other = 0; other < count; ++other)
+				{
+					if (other == i)
+						continue;
+
+					const double r[3] = { difference(x.x[other], x.x[i]), difference(x.y[other], x.y[i]), difference(x.z[other], x.z[i]) };
+					const double u[3] = { difference(v.x[other], v.x[i]), difference(v.y[other], v.y[i]), difference(v.z[other], v.z[i]) };
+
+					const double distanceSquared = r[0] * r[0] + r[1] * r[1] + r[2] * r[2] + softeningSquared;
+					if (distanceSquared <= 0.0)
+						continue;
+
+					const double inverseDistance = 1.0 / std::sqrt(distanceSquared);
+					const double factor = GRAVITATIONAL_CONSTANT * b.mass[other] * inverseDistance * inverseDistance * inverseDistance;
+					const double radialVelocity = 3.0 * (r[0] * u[0] + r[1] * u[1] + r[2] * u[2]) / distanceSquared;
+
+					for (int axis = 0; axis < 3; ++axis)
+					{
+						a[axis] += factor * r[axis];
+						j[axis] += factor * (u[axis] - radialVelocity * r[axis]);
+					}
+				}
+
+				b.gravitationalForce.set(i, b.mass[i] * glm::vec3(static_cast<float>(a[0]), static_cast<float>(a[1]), static_cast<float>(a[2])));
+			}
+
+			world.computeInstantCharachteristics(predicted, i);
+
+			newAcceleration.set(i, b.acceleration.get(i));
+			newJerk.set(i, glm::vec3(static_cast<float>(j[0]), static_cast<float>(j[1]), static_cast<float>(j[2])));
+		}
+	});
+}
+
+template <class Precision>
+void BasicHermiteIntegrator<Precision>::initialize(BasicWorld<Precision>& world, const float& dt)
+{
+	const BasicBodyStore<Precision>& b = world.bodies();
+	const std::size_t count = b.size();
+
+	state = b.current();
+	predicted = state;
+
+	acceleration.resize(count);
+	jerk.resize(count);
+	newAcceleration.resize(count);
+	newJerk.resize(count);
+
+	bodyTime.assign(count, 0);
+	level.assign(count, 0);
+	baseTimestep = dt;
+
+	active.resize(count);
+	for (std::size_t i = 0; i < count; ++i)
+		active[i] = i;
+
+	evaluate(world, active);
+	acceleration = newAcceleration;
+	jerk = newJerk;
+
+	// Initial steps from |a| / |j|
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const float j = glm::length(jerk.get(i));
+		level[i] = j > 0.0f ? selectLevel(dt, initialAccuracy * glm::length(acceleration.get(i)) / j) : 0;
+	}
+
+	statistics.forceEvaluations += count;
+	statistics.sharedStepForceEvaluations += count;
+}
+
+template <class Precision>
+int BasicHermiteIntegrator<Precision>::selectLevel(const float& dt, const float& timestep) const
+{
+	// Also catches NaN
+	if (!(timestep < dt))
+		return 0;
+
+	int result = 0;
+	float step = dt;
+	while (step > timestep && result < maxLevel)
+	{
+		step *= 0.5f;
+		++result;
+	}
+	return result;
+}
+
+template class BasicHermiteIntegrator<SinglePrecision>;
+template class BasicHermiteIntegrator<DoublePrecision>;
+template class BasicHermiteIntegrator<FixedPointPrecision>;
@@ -0,0 +1,92 @@
+#pragma once
+
+// Std. Includes
+#include <cstdint>
+#include <vector>
+
+// Classes
+#include "Integrator.h"
+
+// Force evaluation counters of the block-timestep integrator
+struct HermiteStatistics
+{
+	// Single-body force evaluations actually done
+	std::uint64_t forceEvaluations = 0;
+	// Evaluations a shared timestep would have needed: every body at the smallest step of each base step
+	std::uint64_t sharedStepForceEvaluations = 0;
+	// Block substeps taken
+	std::uint64_t substeps = 0;
+	// Deepest level used during the last step; the smallest body step was dt / 2^deepestLevel
+	int deepestLevel = 0;
+
+	std::uint64_t getSavedForceEvaluations() const
+	{
+		return sharedStepForceEvaluations > forceEvaluations ? sharedStepForceEvaluations - forceEvaluations : 0;
+	}
+};
+
+// Fourth-order Hermite predictor-corrector on hierarchical block timesteps.
+// Every body has its own step dt / 2^level, chosen from its acceleration derivatives (Aarseth criterion).
+// Steps are powers of two of the base step, so bodies sharing a level are due at the same instant and
+// all of them are synchronised again at the end of each base step. A substep predicts every body to the
+// block time from its acceleration and jerk, re-evaluates only the due ("active") bodies and corrects them.
+//
+// Mutual gravity and its jerk come from the softened direct sum in double; the solver option is ignored.
+// Prediction and correction are done in double and applied to the state in its own precision.
+// The remaining forces (developed force, drag, the astronomical object) are evaluated through
+// World::computeInstantCharachteristics() and held constant over a body step.
+template <class Precision>
+class BasicHermiteIntegrator : public BasicIntegrator<Precision>
+{
+public:
+	void step(BasicWorld<Precision>& world, const float& dt) override;
+	const char* getName() const override { return "Hermite (block timesteps)"; }
+	// One evaluation per active body and substep; the number of substeps varies
+	int getStageCount() const override { return 1; }
+
+	const HermiteStatistics& getStatistics() const { return statistics; }
+	void resetStatistics() { statistics = HermiteStatistics(); }
+
+	// Accuracy parameters of the initial and the running step estimate
+	float initialAccuracy = 0.01f;
+	float accuracy = 0.02f;
+	// Finest level: steps never get shorter than dt / 2^maxLevel
+	int maxLevel = 16;
+
+private:
+	// Evaluates the total acceleration and the gravitational jerk of the listed bodies in the predicted state
+	void evaluate(BasicWorld<Precision>& world, const std::vector<std::size_t>& bodies);
+	// Full evaluation of every body at the start of the base step and their first levels
+	void initialize(BasicWorld<Precision>& world, const float& dt);
+
+	// Level whose step dt / 2^level is the longest one not exceeding timestep
+	int selectLevel(const float& dt, const float& timestep) const;
+
+private:
+	// Every body at its own last time, synchronised at the end of every base step
+	BasicBodyState<Precision> state;
+	// Every body extrapolated to the current block time
+	BasicBodyState<Precision> predicted;
+
+	Vector3Array acceleration;
+	Vector3Array jerk;
+
+	// Acceleration and jerk of the active bodies at the block time
+	Vector3Array newAcceleration;
+	Vector3Array newJerk;
+
+	// Last time of each body and its step, in ticks of dt / 2^maxLevel
+	std::vector<std::uint64_t> bodyTime;
+	std::vector<int> level;
+
+	std::vector<std::size_t> active;
+
+	float baseTimestep = 0.0f;
+	// Accelerations, jerks and levels stay valid from one base step to the next until the bodies are edited.
+	// Controls do not count: a body's developed force is evaluated again at its next block step.
+	KeptAccelerations keptAccelerations;
+
+	HermiteStatistics statistics;
+};
+
+typedef BasicHermiteIntegrator<SinglePrecision> HermiteIntegrator;
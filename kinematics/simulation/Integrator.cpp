@@ -0,0 +1,153 @@
+#include "Integrator.h"
+
+// Std. Includes
+#include <algorithm>
+#include <cmath>
+
+// Classes
+#include "HermiteIntegrator.h"
+
+namespace
+{
+	// result = base + factor * direction for bodies [begin, end) in the precision of base; result may alias base
+	template <class Scalar, class Direction>
+	void addScaled(std::vector<Scalar>& result, const std::vector<Scalar>& base, const std::vector<Direction>& direction, const float& factor, std::size_t begin, std::size_t end)
+	{
+		for (std::size_t i = begin; i < end; ++i)
+			result[i] = displace(base[i], factor * direction[i]);
+	}
+
+	template <class Scalar, class Direction>
+	void addScaled(BasicVector3Array<Scalar>& result, const BasicVector3Array<Scalar>& base, const BasicVector3Array<Direction>& direction, const float& factor, std::size_t begin, std::size_t end)
+	{
+		addScaled(result.x, base.x, direction.x, factor, begin, end);
+		addScaled(result.y, base.y, direction.y, factor, begin, end);
+		addScaled(result.z, base.z, direction.z, factor, begin, end);
+	}
+}
+
+template <class Precision>
+void SemiImplicitEulerIntegrator<Precision>::step(BasicWorld<Precision>& world, const float& dt)
+{
+	BasicBodyStore<Precision>& bodies = world.bodies();
+	const BasicBodyState<Precision>& current = bodies.current();
+	BasicBodyState<Precision>& next = bodies.next();
+
+	world.computeAccelerations(current);
+
+	world.parallelForBodies([&](std::size_t begin, std::size_t end)
+	{
+		addScaled(next.velocity, current.velocity, bodies.acceleration, dt, begin, end);
+		addScaled(next.coordinates, current.coordinates, next.velocity, dt, begin, end);
+	});
+}
+
+template <class Precision>
+void LeapfrogIntegrator<Precision>::step(BasicWorld<Precision>& world, const float& dt)
+{
+	BasicBodyStore<Precision>& bodies = world.bodies();
+	const BasicBodyState<Precision>& current = bodies.current();
+	BasicBodyState<Precision>& next = bodies.next();
+
+	if (!keptAccelerations.isValid(bodies))
+		world.computeAccelerations(current);
+
+	// Kick, drift
+	world.parallelForBodies([&](std::size_t begin, std::size_t end)
+	{
+		addScaled(next.velocity, current.velocity, bodies.acceleration, 0.5f * dt, begin, end);
+		addScaled(next.coordinates, current.coordinates, next.velocity, dt, begin, end);
+	});
+
+	world.computeAccelerations(next);
+	keptAccelerations.keep(bodies);
+
+	// Kick
+	world.parallelForBodies([&](std::size_t begin, std::size_t end)
+	{
+		addScaled(next.velocity, next.velocity, bodies.acceleration, 0.5f * dt, begin, end);
+	});
+}
+
+template <class Precision>
+void VelocityVerletIntegrator<Precision>::step(BasicWorld<Precision>& world, const float& dt)
+{
+	BasicBodyStore<Precision>& bodies = world.bodies();
+	const BasicBodyState<Precision>& current = bodies.current();
+	BasicBodyState<Precision>& next = bodies.next();
+
+	if (!keptAccelerations.isValid(bodies))
+		world.computeAccelerations(current);
+	initialAcceleration = bodies.acceleration;
+
+	// Position update; the velocity is predicted to first order so drag sees a sensible value
+	world.parallelForBodies([&](std::size_t begin, std::size_t end)
+	{
+		addScaled(next.coordinates, current.coordinates, current.velocity, dt, begin, end);
+		addScaled(next.coordinates, next.coordinates, initialAcceleration, 0.5f * dt * dt, begin, end);
+		addScaled(next.velocity, current.velocity, initialAcceleration, dt, begin, end);
+	});
+
+	world.computeAccelerations(next);
+	keptAccelerations.keep(bodies);
+
+	// Velocity update with the average of both accelerations
+	world.parallelForBodies([&](std::size_t begin, std::size_t end)
+	{
+		addScaled(next.velocity, current.velocity, initialAcceleration, 0.5f * dt, begin, end);
+		addScaled(next.velocity, next.velocity, bodies.acceleration, 0.5f * dt, begin, end);
+	});
+}
+
+template <class Precision>
+void YoshidaIntegrator<Precision>::step(BasicWorld<Precision>& world, const float& dt)
+{
+	// w1 = 1 / (2 - 2^(1/3)), w0 = -2^(1/3) / (2 - 2^(1/3))
+	static const double cubeRootOfTwo = std::cbrt(2.0);
+	static const float w1 = static_cast<float>(1.0 / (2.0 - cubeRootOfTwo));
+	static const float w0 = static_cast<float>(-cubeRootOfTwo / (2.0 - cubeRootOfTwo));
+
+	// Drift and kick coefficients
+	const float c[4] = { 0.5f * w1, 0.5f * (w0 + w1), 0.5f * (w0 + w1), 0.5f * w1 };
+	const float d[3] = { w1, w0, w1 };
+
+	BasicBodyStore<Precision>& bodies = world.bodies();
+	const BasicBodyState<Precision>& current = bodies.current();
+	BasicBodyState<Precision>& next = bodies.next();
+
+	world.parallelForBodies([&](std::size_t begin, std::size_t end)
+	{
+		addScaled(next.coordinates, current.coordinates, current.velocity, c[0] * dt, begin, end);
+		std::copy(current.velocity.x.begin() + begin, current.velocity.x.begin() + end, next.velocity.x.begin() + begin);
+		std::copy(current.velocity.y.begin() + begin, current.velocity.y.begin() + end, next.velocity.y.begin() + begin);
+		std::copy(current.velocity.z.begin() + begin, current.velocity.z.begin() + end, next.velocity.z.begin() + begin);
+	});
+
+	for (int stage = 0; stage < 3; ++stage)
+	{
+		world.computeAccelerations(next);
+
+		world.parallelForBodies([&](std::size_t begin, std::size_t end)
+		{
+			addScaled(next.velocity, next.velocity, bodies.acceleration, d[stage] * dt, begin, end);
+			addScaled(next.coordinates, next.coordinates, next.velocity, c[stage + 1] * dt, begin, end);
+		});
+	}
+}
+
+template <class Precision>
+std::unique_ptr<BasicIntegrator<Precision>> createIntegrator(const int& type)
+{
+	switch (type)
+	{
+	case LEAPFROG: return std::unique_ptr<BasicIntegrator<Precision>>(new LeapfrogIntegrator<Precision>());
+	case VELOCITY_VERLET: return std::unique_ptr<BasicIntegrator<Precision>>(new VelocityVerletIntegrator<Precision>());
+	case YOSHIDA4: return std::unique_ptr<BasicIntegrator<Precision>>(new YoshidaIntegrator<Precision>());
+	case HERMITE_BLOCK: return std::unique_ptr<BasicIntegrator<Precision>>(new BasicHermiteIntegrator<Precision>());
+	default: return std::unique_ptr<BasicIntegrator<Precision>>(new SemiImplicitEulerIntegrator<Precision>());
+	}
+}
+
+template std::unique_ptr<BasicIntegrator<SinglePrecision>> createIntegrator<SinglePrecision>(const int& type);
+template std::unique_ptr<BasicIntegrator<DoublePrecision>> createIntegrator<DoublePrecision>(const int& type);
+template std::unique_ptr<BasicIntegrator<FixedPointPrecision>> createIntegrator<FixedPointPrecision>(const int& type);
@@ -0,0 +1,101 @@
+#pragma once
+
+// Std. Includes
+#include <cstdint>
+#include <memory>
+
+// Classes
+#include "World.h"
+
+// Time integration scheme.
+// step() advances world.bodies() from current() into next() over dt, evaluating forces through
+// World::computeAccelerations(); World::step() swaps the states afterwards.
+template <class Precision>
+class BasicIntegrator
+{
+public:
+	virtual ~BasicIntegrator() {}
+
+	virtual void step(BasicWorld<Precision>& world, const float& dt) = 0;
+
+	virtual const char* getName() const = 0;
+	// Force evaluations per step
+	virtual int getStageCount() const = 0;
+};
+
+typedef BasicIntegrator<SinglePrecision> Integrator;
+
+// First same as last: the accelerations evaluated at the end of a step are the ones the next step starts from,
+// as long as nothing edited the bodies in between (see BodyProperties::getRevision()).
+// With velocity-dependent forces they were evaluated with the velocity of the last force stage, as the last kick used them.
+// Controls applied in between leave them valid: the first kick of the step then uses the developed force of the end of
+// the last step, and the change shows from the next force evaluation on, half a step later at most.
+class KeptAccelerations
+{
+public:
+	bool isValid(const BodyProperties& bodies) const { return kept && revision == bodies.getRevision(); }
+	void keep(const BodyProperties& bodies)
+	{
+		kept = true;
+		revision = bodies.getRevision();
+	}
+
+private:
+	bool kept = false;
+	std::uint64_t revision = 0;
+};
+
+// v += a * dt; x += v * dt. First order, one force evaluation.
+template <class Precision>
+class SemiImplicitEulerIntegrator : public BasicIntegrator<Precision>
+{
+public:
+	void step(BasicWorld<Precision>& world, const float& dt) override;
+	const char* getName() const override { return "Semi-implicit Euler"; }
+	int getStageCount() const override { return 1; }
+};
+
+// Kick-drift-kick leapfrog: half kick, full drift, half kick. Second order, symplectic.
+// The force evaluation before the last kick also serves the first kick of the next step.
+template <class Precision>
+class LeapfrogIntegrator : public BasicIntegrator<Precision>
+{
+public:
+	void step(BasicWorld<Precision>& world, const float& dt) override;
+	const char* getName() const override { return "Leapfrog (KDK)"; }
+	int getStageCount() const override { return 1; }
+
+private:
+	KeptAccelerations keptAccelerations;
+};
+
+// x += v * dt + a * dt^2 / 2; v += (a + a') * dt / 2. Second order, symplectic.
+// a' of one step is a of the next, so a step takes one force evaluation.
+template <class Precision>
+class VelocityVerletIntegrator : public BasicIntegrator<Precision>
+{
+public:
+	void step(BasicWorld<Precision>& world, const float& dt) override;
+	const char* getName() const override { return "Velocity Verlet"; }
+	int getStageCount() const override { return 1; }
+
+private:
+	KeptAccelerations keptAccelerations;
+
+	// Acceleration at the beginning of the step
+	Vector3Array initialAcceleration;
+};
+
+// Yoshida's fourth-order composition of three leapfrog steps with weights w1, w0, w1.
+template <class Precision>
+class YoshidaIntegrator : public BasicIntegrator<Precision>
+{
+public:
+	void step(BasicWorld<Precision>& world, const float& dt) override;
+	const char* getName() const override { return "Yoshida (4th order)"; }
+	int getStageCount() const override { return 3; }
+};
+
+// Integrator for one of the SEMI_IMPLICIT_EULER, LEAPFROG, VELOCITY_VERLET, YOSHIDA4, HERMITE_BLOCK options
+template <class Precision>
+std::unique_ptr<BasicIntegrator<Precision>> createIntegrator(const int& type);
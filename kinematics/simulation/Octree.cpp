@@ -0,0 +1,253 @@
+#include "Octree.h"
+
+// Std. Includes
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// GLM
+#include <glm/glm/common.hpp>
+#include <glm/glm/geometric.hpp>
+
+// Classes
+#include "Gravity.h"
+
+void Octree::build(const Vector3Array& coordinates, const std::vector<float>& masses)
+{
+	nodes.clear();
+
+	const std::size_t count = masses.size();
+	if (count == 0)
+		return;
+
+	bodyOrder.resize(count);
+	scratch.resize(count);
+	for (std::size_t i = 0; i < count; ++i)
+		bodyOrder[i] = static_cast<unsigned int>(i);
+
+	// Bounding cube of all bodies
+	glm::vec3 minimum = coordinates.get(0);
+	glm::vec3 maximum = minimum;
+	for (std::size_t i = 1; i < count; ++i)
+	{
+		minimum = glm::min(minimum, coordinates.get(i));
+		maximum = glm::max(maximum, coordinates.get(i));
+	}
+
+	const glm::vec3 extent = maximum - minimum;
+	float halfSize = 0.5f * std::max(extent.x, std::max(extent.y, extent.z));
+	// Slightly enlarged so bodies on the upper faces still fall inside
+	halfSize = halfSize > 0.0f ? halfSize * 1.001f : 1.0f;
+
+	Node root = {};
+	root.center = 0.5f * (minimum + maximum);
+	root.halfSize = halfSize;
+	root.firstChild = -1;
+	root.begin = 0;
+	root.end = static_cast<unsigned int>(count);
+	nodes.push_back(root);
+
+	subdivide(coordinates, masses, 0, 0);
+}
+
+void Octree::subdivide(const Vector3Array& coordinates, const std::vector<float>& masses, const int& node, const int& depth)
+{
+	const unsigned int begin = nodes[node].begin;
+	const unsigned int end = nodes[node].end;
+
+	// Leaf: accumulate the bodies directly
+	if (end - begin <= LEAF_CAPACITY || depth >= MAX_DEPTH)
+	{
+		float mass = 0.0f;
+		glm::vec3 weightedCoordinates(0.0f);
+
+		for (unsigned int k = begin; k < end; ++k)
+		{
+			const unsigned int body = bodyOrder[k];
+			mass += masses[body];
+			weightedCoordinates += masses[body] * coordinates.get(body);
+		}
+
+		nodes[node].mass = mass;
+		nodes[node].centerOfMass = mass > 0.0f ? weightedCoordinates / mass : nodes[node].center;
+		return;
+	}
+
+	// Sort the node's bodies by octant: bit 0 - x, bit 1 - y, bit 2 - z
+	const glm::vec3 center = nodes[node].center;
+	const float childHalfSize = 0.5f * nodes[node].halfSize;
+
+	unsigned int octantBegin[9] = { 0 };
+	for (unsigned int k = begin; k < end; ++k)
+	{
+		const glm::vec3 point = coordinates.get(bodyOrder[k]);
+		const int octant = (point.x >= center.x) | ((point.y >= center.y) << 1) | ((point.z >= center.z) << 2);
+		++octantBegin[octant + 1];
+	}
+	for (int octant = 0; octant < 8; ++octant)
+		octantBegin[octant + 1] += octantBegin[octant];
+
+	unsigned int cursor[8];
+	for (int octant = 0; octant < 8; ++octant)
+		cursor[octant] = begin + octantBegin[octant];
+
+	for (unsigned int k = begin; k < end; ++k)
+	{
+		const glm::vec3 point = coordinates.get(bodyOrder[k]);
+		const int octant = (point.x >= center.x) | ((point.y >= center.y) << 1) | ((point.z >= center.z) << 2);
+		scratch[cursor[octant]++] = bodyOrder[k];
+	}
+	std::copy(scratch.begin() + begin, scratch.begin() + end, bodyOrder.begin() + begin);
+
+	// Children (nodes may reallocate here, so only indices are kept)
+	const int firstChild = static_cast<int>(nodes.size());
+	nodes[node].firstChild = firstChild;
+	nodes.resize(nodes.size() + 8);
+
+	for (int octant = 0; octant < 8; ++octant)
+	{
+		Node& child = nodes[firstChild + octant];
+		child.center = center + childHalfSize * glm::vec3(
+			(octant & 1) ? 1.0f : -1.0f,
+			(octant & 2) ? 1.0f : -1.0f,
+			(octant & 4) ? 1.0f : -1.0f);
+		child.halfSize = childHalfSize;
+		child.firstChild = -1;
+		child.begin = begin + octantBegin[octant];
+		child.end = begin + octantBegin[octant + 1];
+	}
+
+	float mass = 0.0f;
+	glm::vec3 weightedCoordinates(0.0f);
+
+	for (int octant = 0; octant < 8; ++octant)
+	{
+		subdivide(coordinates, masses, firstChild + octant, depth + 1);
+
+		const Node& child = nodes[firstChild + octant];
+		mass += child.mass;
+		weightedCoordinates += child.mass * child.centerOfMass;
+	}
+
+	nodes[node].mass = mass;
+	nodes[node].centerOfMass = mass > 0.0f ? weightedCoordinates / mass : center;
+}
+
+glm::vec3 Octree::computeAcceleration(
+	const Vector3Array& coordinates,
+	const std::vector<float>& masses,
+	const glm::vec3& point,
+	const std::size_t& skipBody,
+	const float& openingAngle,
+	const float& softeningSquared) const
+{
+	glm::vec3 acceleration(0.0f);
+
+	if (nodes.empty())
+		return acceleration;
+
+	const float openingAngleSquared = openingAngle * openingAngle;
+
+	// Depth-first traversal; every level pushes at most 8 children
+	int stack[8 * (MAX_DEPTH + 1)];
+	int top = 0;
+	stack[top++] = 0;
+
+	while (top > 0)
+	{
+		const Node& node = nodes[stack[--top]];
+
+		if (node.mass == 0.0f)
+			continue;
+
+		if (node.firstChild == -1)
+		{
+			for (unsigned int k = node.begin; k < node.end; ++k)
+			{
+				const unsigned int body = bodyOrder[k];
+				if (body == skipBody)
+					continue;
+
+				const glm::vec3 r = coordinates.get(body) - point;
+				const float distanceSquared = glm::dot(r, r) + softeningSquared;
+				if (distanceSquared == 0.0f)
+					continue;
+
+				acceleration += masses[body] / (distanceSquared * std::sqrt(distanceSquared)) * r;
+			}
+			continue;
+		}
+
+		const glm::vec3 r = node.centerOfMass - point;
+		const float distanceSquared = glm::dot(r, r);
+		const float size = 2.0f * node.halfSize;
+
+		// A node around the point itself is always opened: with a wide opening angle it may pass the test, but its
+		// monopole would hold the body the point belongs to and pull it towards itself
+		const glm::vec3 offset = point - node.center;
+		const bool containsPoint = std::fabs(offset.x) <= node.halfSize && std::fabs(offset.y) <= node.halfSize && std::fabs(offset.z) <= node.halfSize;
+
+		// Far enough: the whole node acts as a single point mass
+		if (!containsPoint && size * size < openingAngleSquared * distanceSquared)
+		{
+			const float softenedDistanceSquared = distanceSquared + softeningSquared;
+			acceleration += node.mass / (softenedDistanceSquared * std::sqrt(softenedDistanceSquared)) * r;
+			continue;
+		}
+
+		for (int octant = 0; octant < 8; ++octant)
+			stack[top++] = node.firstChild + octant;
+	}
+
+	return GRAVITATIONAL_CONSTANT * acceleration;
+}
+
+GravityErrorReport measureBarnesHutError(
+	const BodyStore& bodies,
+	const float& openingAngle,
+	const float& softeningSquared,
+	const std::size_t& maxSamples)
+{
+	typedef std::chrono::steady_clock Clock;
+
+	GravityErrorReport report;
+
+	const std::size_t count = bodies.size();
+	if (count == 0 || maxSamples == 0)
+		return report;
+
+	const std::size_t stride = std::max<std::size_t>(1, count / maxSamples);
+
+	std::vector<glm::vec3> direct;
+	Clock::time_point start = Clock::now();
+	for (std::size_t i = 0; i < count; i += stride)
+		direct.push_back(directGravitationalAcceleration(bodies, bodies.current().coordinates.get(i), i, softeningSquared));
+	report.directSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	Octree octree;
+	std::vector<glm::vec3> approximated;
+	start = Clock::now();
+	const Vector3Array& coordinates = bodies.current().coordinates;
+	octree.build(coordinates, bodies.mass);
+	for (std::size_t i = 0; i < count; i += stride)
+		approximated.push_back(octree.computeAcceleration(coordinates, bodies.mass, coordinates.get(i), i, openingAngle, softeningSquared));
+	report.barnesHutSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	double errorSum = 0.0;
+	for (std::size_t k = 0; k < direct.size(); ++k)
+	{
+		const float reference = glm::length(direct[k]);
+		if (reference == 0.0f)
+			continue;
+
+		const float error = glm::length(approximated[k] - direct[k]) / reference;
+		report.maxRelativeError = std::max(report.maxRelativeError, error);
+		errorSum += error;
+		++report.sampledBodies;
+	}
+
+	if (report.sampledBodies > 0)
+		report.meanRelativeError = static_cast<float>(errorSum / report.sampledBodies);
+
+	return report;
+}
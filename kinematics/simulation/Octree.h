@@ -0,0 +1,75 @@
+#pragma once
+
+// Std. Includes
+#include <vector>
+
+// Classes
+#include "BodyStore.h"
+
+// Barnes-Hut octree over the body coordinates.
+// Rebuilt from scratch every step; a node whose size s seen from distance d satisfies s / d < openingAngle, and that
+// does not contain the point evaluated at, is replaced by its total mass placed at its centre of mass, so a force
+// evaluation costs O(log N) instead of O(N).
+class Octree
+{
+public:
+	void build(const Vector3Array& coordinates, const std::vector<float>& masses);
+
+	// Gravitational acceleration at the given point produced by every body except skipBody.
+	// coordinates and masses must be the arrays the tree was built from.
+	glm::vec3 computeAcceleration(
+		const Vector3Array& coordinates,
+		const std::vector<float>& masses,
+		const glm::vec3& point,
+		const std::size_t& skipBody,
+		const float& openingAngle,
+		const float& softeningSquared = 0.0f
+	) const;
+
+	std::size_t getNodeCount() const { return nodes.size(); }
+
+private:
+	struct Node
+	{
+		glm::vec3 center;
+		float halfSize;
+
+		glm::vec3 centerOfMass;
+		float mass;
+
+		// Children are allocated as 8 consecutive nodes, -1 for a leaf
+		int firstChild;
+
+		// Range of the bodies inside this node in bodyOrder
+		unsigned int begin, end;
+	};
+
+	void subdivide(const Vector3Array& coordinates, const std::vector<float>& masses, const int& node, const int& depth);
+
+private:
+	std::vector<Node> nodes;
+	std::vector<unsigned int> bodyOrder;
+	std::vector<unsigned int> scratch;
+
+	static const unsigned int LEAF_CAPACITY = 8;
+	static const int MAX_DEPTH = 32;
+};
+
+// Accuracy of the Barnes-Hut approximation against the direct sum
+struct GravityErrorReport
+{
+	float maxRelativeError = 0.0f;
+	float meanRelativeError = 0.0f;
+	std::size_t sampledBodies = 0;
+
+	double directSeconds = 0.0;
+	double barnesHutSeconds = 0.0;
+};
+
+// Compares both solvers on up to maxSamples evenly spaced bodies, so it stays cheap on large scenes
+GravityErrorReport measureBarnesHutError(
+	const BodyStore& bodies,
+	const float& openingAngle,
+	const float& softeningSquared = 0.0f,
+	const std::size_t& maxSamples = 256
+);
@@ -0,0 +1,86 @@
+#pragma once
+
+// Std. Includes
+#include <cmath>
+#include <cstdint>
+
+// Signed Q31.32 fixed-point coordinate: 2^-32 m (about 0.2 nm) resolution everywhere in +-2^31 m.
+// Unlike float, the resolution does not get coarser away from the origin, and differences are exact.
+class Fixed64
+{
+public:
+	Fixed64() : raw(0) {}
+	explicit Fixed64(const double& value) : raw(static_cast<std::int64_t>(std::llround(value * ONE))) {}
+
+	static Fixed64 fromRaw(const std::int64_t& raw)
+	{
+		Fixed64 result;
+		result.raw = raw;
+		return result;
+	}
+
+	double toDouble() const { return static_cast<double>(raw) / ONE; }
+
+	Fixed64 operator+(const Fixed64& other) const { return fromRaw(raw + other.raw); }
+	Fixed64 operator-(const Fixed64& other) const { return fromRaw(raw - other.raw); }
+	bool operator==(const Fixed64& other) const { return raw == other.raw; }
+	bool operator!=(const Fixed64& other) const { return raw != other.raw; }
+
+public:
+	std::int64_t raw;
+
+	static constexpr double ONE = 4294967296.0;
+};
+
+// Precision policies of the simulation state.
+// Position is the type coordinates are stored and advanced in, Velocity the type of the velocities.
+// Forces, accelerations and body properties stay float in every policy.
+
+// Everything in float: fastest, but the resolution is 0.5 m at 6.4e6 m from the origin
+struct SinglePrecision
+{
+	typedef float Position;
+	typedef float Velocity;
+	static const char* getName() { return "float"; }
+};
+
+// Coordinates and velocities in double
+struct DoublePrecision
+{
+	typedef double Position;
+	typedef double Velocity;
+	static const char* getName() { return "double"; }
+};
+
+// Fixed-point coordinates, double velocities. Differences of coordinates are exact, and the resolution
+// is the same everywhere, so results do not depend on where the origin is
+struct FixedPointPrecision
+{
+	typedef Fixed64 Position;
+	typedef double Velocity;
+	static const char* getName() { return "fixed64"; }
+};
+
+// Scalar conversions shared by the precision policies
+inline double toDouble(const float& value) { return value; }
+inline double toDouble(const double& value) { return value; }
+inline double toDouble(const Fixed64& value) { return value.toDouble(); }
+
+inline float toFloat(const float& value) { return value; }
+inline float toFloat(const double& value) { return static_cast<float>(value); }
+inline float toFloat(const Fixed64& value) { return static_cast<float>(value.toDouble()); }
+
+template <class Scalar>
+inline Scalar fromDouble(const double& value) { return static_cast<Scalar>(value); }
+template <>
+inline Fixed64 fromDouble<Fixed64>(const double& value) { return Fixed64(value); }
+
+// a - b; fixed-point differences are taken exactly before the conversion
+inline double difference(const float& a, const float& b) { return static_cast<double>(a) - b; }
+inline double difference(const double& a, const double& b) { return a - b; }
+inline double difference(const Fixed64& a, const Fixed64& b) { return (a - b).toDouble(); }
+
+// base + displacement
+inline float displace(const float& base, const double& displacement) { return base + static_cast<float>(displacement); }
+inline double displace(const double& base, const double& displacement) { return base + displacement; }
+inline Fixed64 displace(const Fixed64& base, const double& displacement) { return base + Fixed64(displacement); }
@@ -0,0 +1,190 @@
+#include "Profiler.h"
+
+// Std. Includes
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+namespace
+{
+	struct ProfileRecord
+	{
+		// Atomic only so the collector may read a record while its thread overwrites it; the copy is thrown away then
+		std::atomic<const char*> stage{ nullptr };
+		std::atomic<std::int64_t> begin{ 0 };
+		std::atomic<std::int64_t> end{ 0 };
+	};
+
+	struct ProfileRing
+	{
+		ProfileRecord records[PROFILER_RING_SIZE];
+		// Records written so far, by the owning thread
+		std::atomic<std::uint64_t> head{ 0 };
+		// Records taken by the collector so far
+		std::uint64_t collected = 0;
+		// Owned by a live thread; the ring of a finished thread goes to the next new one
+		bool inUse = true;
+	};
+
+	struct ProfilerState
+	{
+		std::mutex mutex;
+		std::vector<std::unique_ptr<ProfileRing>> rings;
+
+		std::vector<ProfileStage> stages;
+		std::uint64_t pendingFrames = 0;
+		std::int64_t statisticsTime = 0;
+	};
+
+	// Never destroyed: threads may still finish, and give their rings back, while static objects are destroyed
+	ProfilerState& getState()
+	{
+		static ProfilerState* state = new ProfilerState();
+		return *state;
+	}
+
+	// Lends the calling thread a ring for as long as the thread lives
+	class ProfileThread
+	{
+	public:
+		~ProfileThread()
+		{
+			if (ring == nullptr)
+				return;
+
+			std::lock_guard<std::mutex> lock(getState().mutex);
+			ring->inUse = false;
+		}
+
+		ProfileRing& getRing()
+		{
+			if (ring != nullptr)
+				return *ring;
+
+			ProfilerState& state = getState();
+			std::lock_guard<std::mutex> lock(state.mutex);
+			for (const std::unique_ptr<ProfileRing>& free : state.rings)
+			{
+				if (!free->inUse)
+				{
+					free->inUse = true;
+					ring = free.get();
+					return *ring;
+				}
+			}
+
+			state.rings.push_back(std::unique_ptr<ProfileRing>(new ProfileRing()));
+			ring = state.rings.back().get();
+			return *ring;
+		}
+
+	private:
+		ProfileRing* ring = nullptr;
+	};
+
+	ProfileStage& findStage(std::vector<ProfileStage>& stages, const char* name)
+	{
+		// The same literal may have a different address in every translation unit
+		for (ProfileStage& stage : stages)
+		{
+			if (stage.name == name || std::strcmp(stage.name, name) == 0)
+				return stage;
+		}
+
+		stages.push_back(ProfileStage());
+		stages.back().name = name;
+		stages.back().history.reserve(PROFILER_HISTORY);
+		return stages.back();
+	}
+
+	void addCall(ProfileStage& stage, const float& milliseconds)
+	{
+		if (stage.history.size() < PROFILER_HISTORY)
+			stage.history.push_back(milliseconds);
+		else
+			stage.history[stage.nextHistory] = milliseconds;
+		stage.nextHistory = (stage.nextHistory + 1) % PROFILER_HISTORY;
+
+		stage.pendingMilliseconds += milliseconds;
+		++stage.pendingCalls;
+	}
+
+	float getPercentile(std::vector<float>& values, const double& percentile)
+	{
+		if (values.empty())
+			return 0.0f;
+
+		const std::size_t rank = static_cast<std::size_t>(percentile * (values.size() - 1) + 0.5);
+		std::nth_element(values.begin(), values.begin() + rank, values.end());
+		return values[rank];
+	}
+}
+
+std::atomic<bool> Profiler::enabled{ false };
+
+void Profiler::record(const char* stage, const std::int64_t& begin, const std::int64_t& end)
+{
+	thread_local ProfileThread thread;
+	ProfileRing& ring = thread.getRing();
+
+	const std::uint64_t head = ring.head.load(std::memory_order_relaxed);
+	ProfileRecord& record = ring.records[head & (PROFILER_RING_SIZE - 1)];
+	record.stage.store(stage, std::memory_order_relaxed);
+	record.begin.store(begin, std::memory_order_relaxed);
+	record.end.store(end, std::memory_order_relaxed);
+	ring.head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::collect()
+{
+	ProfilerState& state = getState();
+	std::lock_guard<std::mutex> lock(state.mutex);
+
+	for (const std::unique_ptr<ProfileRing>& ring : state.rings)
+	{
+		const std::uint64_t head = ring->head.load(std::memory_order_acquire);
+		const std::uint64_t first = std::max(ring->collected, head > PROFILER_RING_SIZE ? head - PROFILER_RING_SIZE : 0);
+
+		for (std::uint64_t i = first; i < head; ++i)
+		{
+			const ProfileRecord& record = ring->records[i & (PROFILER_RING_SIZE - 1)];
+			const char* stage = record.stage.load(std::memory_order_relaxed);
+			const std::int64_t begin = record.begin.load(std::memory_order_relaxed);
+			const std::int64_t end = record.end.load(std::memory_order_relaxed);
+
+			// Record i is overwritten once the thread is writing record i + PROFILER_RING_SIZE
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (i + PROFILER_RING_SIZE <= ring->head.load(std::memory_order_relaxed))
+				continue;
+
+			addCall(findStage(state.stages, stage), (end - begin) * 1.0e-6f);
+		}
+		ring->collected = head;
+	}
+	++state.pendingFrames;
+
+	const std::int64_t time = now();
+	if ((time - state.statisticsTime) * 1.0e-9 < PROFILER_STATISTICS_INTERVAL)
+		return;
+
+	std::vector<float> values;
+	for (ProfileStage& stage : state.stages)
+	{
+		stage.millisecondsPerFrame = stage.pendingMilliseconds / state.pendingFrames;
+		stage.callsPerFrame = static_cast<double>(stage.pendingCalls) / state.pendingFrames;
+		stage.pendingMilliseconds = 0.0;
+		stage.pendingCalls = 0;
+
+		values = stage.history;
+		stage.p50 = getPercentile(values, 0.50);
+		stage.p99 = getPercentile(values, 0.99);
+	}
+	state.pendingFrames = 0;
+	state.statisticsTime = time;
+}
+
+const std::vector<ProfileStage>& Profiler::getStages()
+{
+	return getState().stages;
+}
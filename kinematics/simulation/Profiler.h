@@ -0,0 +1,88 @@
+#pragma once
+
+// Std. Includes
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#define PROFILER_RING_SIZE 4096 // timings a thread can record between two collections; a power of two
+#define PROFILER_HISTORY 256 // latest calls of a stage the percentiles are taken over
+#define PROFILER_STATISTICS_INTERVAL 0.25 // s between updates of the statistics
+
+// Times the rest of the enclosing scope as the given stage; name is a string literal
+#define PROFILE_SCOPE(name) PROFILE_SCOPE_AT(name, __LINE__)
+#define PROFILE_SCOPE_AT(name, line) ProfileScope PROFILE_SCOPE_VARIABLE(line)(name)
+#define PROFILE_SCOPE_VARIABLE(line) profileScope##line
+
+// Timing statistics of one stage
+struct ProfileStage
+{
+	const char* name;
+
+	// Durations of the latest calls, ms; the oldest is overwritten first
+	std::vector<float> history;
+	std::size_t nextHistory = 0;
+
+	// Over the last statistics interval
+	double millisecondsPerFrame = 0.0;
+	double callsPerFrame = 0.0;
+	// Over the history, ms per call
+	float p50 = 0.0f;
+	float p99 = 0.0f;
+
+	// Accumulated since the last statistics update
+	double pendingMilliseconds = 0.0;
+	std::uint64_t pendingCalls = 0;
+};
+
+// Frame pipeline profiler. Scoped timers on any thread record (stage, begin, end) into a ring buffer owned by
+// their thread: the thread is the only writer, so recording is two clock reads and a few relaxed stores, with no
+// lock and nothing shared with other recording threads. Once a frame the render thread collects the rings into
+// per-stage statistics. While disabled, a timer costs one relaxed load.
+class Profiler
+{
+public:
+	static void setEnabled(const bool& enabled) { Profiler::enabled.store(enabled, std::memory_order_relaxed); }
+	static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+	// Nanoseconds on the steady clock
+	static std::int64_t now() { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+
+	// Any thread: one call of stage from begin to end
+	static void record(const char* stage, const std::int64_t& begin, const std::int64_t& end);
+
+	// One thread only, once a frame: takes the timings recorded since the last call.
+	// Timings a thread recorded beyond PROFILER_RING_SIZE since then are lost.
+	static void collect();
+	// Stages in the order they were first seen, as of the last collect()
+	static const std::vector<ProfileStage>& getStages();
+
+private:
+	static std::atomic<bool> enabled;
+};
+
+// Records the time from its construction to its destruction, if the profiler was enabled when it was constructed
+class ProfileScope
+{
+public:
+	explicit ProfileScope(const char* stage)
+		: stage(Profiler::isEnabled() ? stage : nullptr), begin(this->stage != nullptr ? Profiler::now() : 0)
+	{
+
+	}
+
+	~ProfileScope()
+	{
+		if (stage != nullptr)
+			Profiler::record(stage, begin, Profiler::now());
+	}
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+	const char* stage;
+	std::int64_t begin;
+};
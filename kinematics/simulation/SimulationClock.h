@@ -0,0 +1,59 @@
+#pragma once
+
+// Fixed-step simulation clock.
+// Frame time is collected in an accumulator and spent in whole steps of fixedDeltaTime, so the
+// integration step never depends on the frame rate. The remainder is left for render interpolation.
+class SimulationClock
+{
+public:
+	SimulationClock(const float& fixedDeltaTime = 0.01f, const int& maxSubsteps = 8)
+		: fixedDeltaTime(fixedDeltaTime), maxSubsteps(maxSubsteps), accumulator(0.0f)
+	{
+
+	}
+
+	// Adds the frame time and returns how many fixed steps have to run this frame.
+	// More than maxSubsteps steps are never requested: the time that does not fit is dropped,
+	// so a slow frame does not make the next one slower still (spiral of death).
+	int advance(float frameTime)
+	{
+		if (fixedDeltaTime <= 0.0f)
+			return 0;
+		if (frameTime < 0.0f)
+			frameTime = 0.0f;
+
+		accumulator += frameTime;
+
+		int steps = static_cast<int>(accumulator / fixedDeltaTime);
+		if (steps > maxSubsteps)
+		{
+			steps = maxSubsteps;
+			accumulator = fixedDeltaTime * steps;
+		}
+
+		accumulator -= fixedDeltaTime * steps;
+		if (accumulator < 0.0f)
+			accumulator = 0.0f;
+
+		return steps;
+	}
+
+	// How far the render time is between the last two simulated states, in [0, 1)
+	float getInterpolationFactor() const
+	{
+		if (fixedDeltaTime <= 0.0f)
+			return 1.0f;
+
+		const float alpha = accumulator / fixedDeltaTime;
+		return alpha < 1.0f ? alpha : 1.0f;
+	}
+
+	void reset() { accumulator = 0.0f; }
+
+public:
+	float fixedDeltaTime;
+	int maxSubsteps;
+
+private:
+	float accumulator;
+};
@@ -0,0 +1,360 @@
+#include "SimulationThread.h"
+
+// Std. Includes
+#include <algorithm>
+#include <future>
+
+// Classes
+#include "Profiler.h"
+
+float WorldSnapshot::getInterpolationFactor(const std::chrono::steady_clock::time_point& now) const
+{
+	if (paused)
+		return interpolationFactor;
+	if (fixedDeltaTime <= 0.0f)
+		return 1.0f;
+
+	const float alpha = interpolationFactor + std::chrono::duration<float>(now - publishTime).count() / fixedDeltaTime;
+	return alpha < 1.0f ? alpha : 1.0f;
+}
+
+SimulationThread::SimulationThread(World& world, const SimulationClock& clock) : world(world), requestedClock(clock), clock(clock)
+{
+
+}
+
+SimulationThread::~SimulationThread()
+{
+	stop();
+}
+
+void SimulationThread::start()
+{
+	if (running)
+		return;
+
+	stopping = false;
+	running = true;
+	thread = std::thread(&SimulationThread::run, this);
+}
+
+void SimulationThread::stop()
+{
+	if (!running)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_one();
+
+	thread.join();
+	running = false;
+}
+
+void SimulationThread::post(const Command& command)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		commands.push_back(command);
+	}
+	wake.notify_one();
+}
+
+void SimulationThread::execute(const Command& command)
+{
+	if (!running)
+	{
+		command(world);
+		return;
+	}
+
+	std::promise<void> done;
+	std::future<void> ran = done.get_future();
+	post([&command, &done](World& world)
+	{
+		command(world);
+		done.set_value();
+	});
+	ran.wait();
+}
+
+void SimulationThread::request(const Request& request)
+{
+	post([this, request](World& world)
+	{
+		const Completion completion = request(world);
+
+		// Commands run just before the round publishes
+		std::lock_guard<std::mutex> lock(mutex);
+		completions.push_back(std::make_pair(publications + 1, completion));
+	});
+}
+
+void SimulationThread::measureEnergy()
+{
+	post([this](World& world)
+	{
+		totalEnergy = world.computeTotalEnergy();
+		energyStep = steps;
+		energyMeasured = true;
+	});
+}
+
+void SimulationThread::setPaused(const bool& paused)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		this->paused = paused;
+	}
+	wake.notify_one();
+}
+
+void SimulationThread::setTimeStep(const float& fixedDeltaTime, const int& maxSubsteps)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		requestedClock.fixedDeltaTime = fixedDeltaTime;
+		requestedClock.maxSubsteps = maxSubsteps;
+	}
+	wake.notify_one();
+}
+
+bool SimulationThread::acquire()
+{
+	if (!snapshots.acquire())
+		return false;
+
+	acquiredStep.store(getSnapshot().steps, std::memory_order_release);
+
+	// Completions are queued in the order of their publications
+	std::vector<std::pair<std::uint64_t, Completion>> shown;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		const std::uint64_t publication = getSnapshot().publication;
+		const std::vector<std::pair<std::uint64_t, Completion>>::iterator hidden = std::find_if(completions.begin(), completions.end(),
+			[publication](const std::pair<std::uint64_t, Completion>& completion) { return completion.first > publication; });
+		shown.assign(completions.begin(), hidden);
+		completions.erase(completions.begin(), hidden);
+	}
+	for (const std::pair<std::uint64_t, Completion>& completion : shown)
+		completion.second();
+
+	return true;
+}
+
+void SimulationThread::advanceTo(const std::chrono::steady_clock::time_point& now)
+{
+	if (running)
+		return;
+
+	std::vector<Command> batch;
+	bool pause;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		clock.fixedDeltaTime = requestedClock.fixedDeltaTime;
+		clock.maxSubsteps = requestedClock.maxSubsteps;
+		batch.swap(commands);
+		pause = paused;
+	}
+
+	bool changed = !clockStarted;
+	if (!clockStarted)
+	{
+		lastAdvance = rateStart = now;
+		clockStarted = true;
+	}
+
+	changed |= runCommands(batch);
+	changed |= update(pause, now);
+	if (changed)
+		publish();
+}
+
+void SimulationThread::run()
+{
+	std::vector<Command> batch;
+	bool stop = false;
+
+	lastAdvance = rateStart = std::chrono::steady_clock::now();
+	clockStarted = true;
+	publish();
+
+	while (!stop)
+	{
+		bool pause;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			clock.fixedDeltaTime = requestedClock.fixedDeltaTime;
+			clock.maxSubsteps = requestedClock.maxSubsteps;
+
+			// Sleeps until the next step is due, unless there is something else to do first
+			if (paused || clock.fixedDeltaTime <= 0.0f)
+				wake.wait(lock, [this]() { return stopping || !commands.empty() || (!paused && requestedClock.fixedDeltaTime > 0.0f); });
+			else
+			{
+				const std::chrono::duration<float> untilStep(clock.fixedDeltaTime * (1.0f - clock.getInterpolationFactor()));
+				wake.wait_until(lock, lastAdvance + std::chrono::duration_cast<std::chrono::steady_clock::duration>(untilStep),
+					[this]() { return stopping || !commands.empty() || paused; });
+			}
+
+			batch.swap(commands);
+			stop = stopping;
+			pause = paused;
+		}
+
+		bool changed = runCommands(batch);
+		changed |= update(pause, std::chrono::steady_clock::now());
+		if (changed)
+			publish();
+	}
+}
+
+bool SimulationThread::runCommands(std::vector<Command>& batch)
+{
+	const bool ran = !batch.empty();
+	for (const Command& command : batch)
+		command(world);
+	batch.clear();
+	return ran;
+}
+
+bool SimulationThread::update(const bool& pause, const std::chrono::steady_clock::time_point& now)
+{
+	bool changed = false;
+	if (pause)
+		// Time spent paused is not simulated later
+		lastAdvance = now;
+	else
+		changed = advance(now) > 0;
+
+	changed |= pause == stepping;
+	stepping = !pause;
+	return changed;
+}
+
+int SimulationThread::advance(const std::chrono::steady_clock::time_point& now)
+{
+	const int substeps = clock.advance(std::chrono::duration<float>(now - lastAdvance).count());
+	lastAdvance = now;
+
+	// The steps catch the simulation up with the wall clock: the last one ends where the clock's remainder begins
+	const std::chrono::steady_clock::duration fixedDeltaTime = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(clock.fixedDeltaTime));
+	const std::chrono::steady_clock::time_point lastStepEnd = now - std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+		std::chrono::duration<float>(clock.fixedDeltaTime * clock.getInterpolationFactor()));
+
+	for (int step = 0; step < substeps; ++step)
+	{
+		applyControls(lastStepEnd - (substeps - 1 - step) * fixedDeltaTime);
+
+		const std::chrono::steady_clock::time_point stepStart = std::chrono::steady_clock::now();
+		world.step(clock.fixedDeltaTime);
+		rateStepSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - stepStart).count();
+
+		++steps;
+		simulatedTime += clock.fixedDeltaTime;
+
+		const BodyStore& bodies = world.bodies();
+		for (std::size_t i = 0; i < bodies.size(); ++i)
+			pendingSamples.push_back({ steps, bodies.getHandle(i), bodies.current().coordinates.get(i) });
+	}
+	rateSteps += substeps;
+
+	const double rateSeconds = std::chrono::duration<double>(now - rateStart).count();
+	if (rateSeconds >= SIMULATION_RATE_INTERVAL)
+	{
+		stepRate = rateSteps / rateSeconds;
+		stepTime = rateSteps > 0 ? rateStepSeconds / rateSteps * 1000.0 : 0.0;
+		rateStart = now;
+		rateSteps = 0;
+		rateStepSeconds = 0.0;
+	}
+
+	return substeps;
+}
+
+void SimulationThread::applyControls(const std::chrono::steady_clock::time_point& stepEnd)
+{
+	const std::chrono::steady_clock::time_point stepBegin = stepEnd - std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+		std::chrono::duration<float>(clock.fixedDeltaTime));
+
+	ControlInput input;
+	while (controlInputs.pop(input))
+		pendingControls.push_back(input);
+
+	// Applies a held control for the part of [stepBegin, until) it was held in
+	BodyStore& bodies = world.bodies();
+	const auto apply = [&bodies, &stepBegin](const ControlInput& held, const std::chrono::steady_clock::time_point& until)
+	{
+		const std::chrono::steady_clock::time_point from = std::max(held.time, stepBegin);
+		const std::size_t body = bodies.indexOf(held.body);
+		if (until > from && body != NO_INDEX)
+			bodies.processKeyboardObject(body, held.control, std::chrono::duration<float>(until - from).count());
+	};
+
+	// Presses and releases during the step, in the order they happened
+	while (!pendingControls.empty() && pendingControls.front().time < stepEnd)
+	{
+		const ControlInput& change = pendingControls.front();
+
+		const std::vector<ControlInput>::iterator held = std::find_if(heldControls.begin(), heldControls.end(),
+			[&change](const ControlInput& control) { return control.control == change.control; });
+		if (held != heldControls.end())
+		{
+			apply(*held, change.time);
+			heldControls.erase(held);
+		}
+		if (change.pressed)
+			heldControls.push_back(change);
+
+		pendingControls.pop_front();
+	}
+
+	for (ControlInput& held : heldControls)
+	{
+		apply(held, stepEnd);
+		held.time = stepEnd;
+	}
+}
+
+void SimulationThread::publish()
+{
+	PROFILE_SCOPE("Publish");
+
+	// The reader has the samples up to the step it acquired; it skips any it is given again.
+	// A reader that stalls loses the oldest steps instead of the backlog growing with every step.
+	const std::uint64_t acquired = acquiredStep.load(std::memory_order_acquire);
+	const std::uint64_t oldest = std::max(acquired, steps > SAMPLE_BACKLOG_STEPS ? steps - SAMPLE_BACKLOG_STEPS : 0);
+	const std::vector<TrajectorySample>::iterator unread = std::find_if(pendingSamples.begin(), pendingSamples.end(),
+		[oldest](const TrajectorySample& sample) { return sample.step > oldest; });
+	pendingSamples.erase(pendingSamples.begin(), unread);
+
+	WorldSnapshot& snapshot = snapshots.getBackBuffer();
+	snapshot.bodies = world.bodies();
+	snapshot.samples = pendingSamples;
+
+	snapshot.steps = steps;
+	snapshot.simulatedTime = simulatedTime;
+
+	snapshot.fixedDeltaTime = clock.fixedDeltaTime;
+	snapshot.interpolationFactor = clock.getInterpolationFactor();
+	snapshot.publishTime = lastAdvance;
+	snapshot.paused = !stepping;
+
+	snapshot.stepRate = stepRate;
+	snapshot.stepTime = stepTime;
+
+	const HermiteIntegrator* hermite = dynamic_cast<const HermiteIntegrator*>(&world.getIntegrator());
+	snapshot.hermite = hermite != nullptr;
+	if (hermite != nullptr)
+		snapshot.hermiteStatistics = hermite->getStatistics();
+
+	snapshot.energyMeasured = energyMeasured;
+	snapshot.totalEnergy = totalEnergy;
+	snapshot.energyStep = energyStep;
+
+	snapshot.publication = ++publications;
+
+	snapshots.publish();
+}
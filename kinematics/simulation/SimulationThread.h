@@ -0,0 +1,194 @@
+#pragma once
+
+// Std. Includes
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// GLM
+#include <glm/glm/vec3.hpp>
+
+// Classes
+#include "HermiteIntegrator.h"
+#include "SimulationClock.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
+#include "World.h"
+
+#define SIMULATION_RATE_INTERVAL 0.5 // s of wall time the step rate is measured over
+#define CONTROL_INPUT_CAPACITY 1024 // control changes in flight from the input thread to the simulation
+#define SAMPLE_BACKLOG_STEPS 1024 // latest steps whose samples are kept for a reader that has not acquired them
+
+// Position of one body after one step, for the trajectories
+struct TrajectorySample
+{
+	std::uint64_t step;
+	BodyHandle body;
+	glm::vec3 coordinates;
+};
+
+// A force vector control of a body pressed or released at the given instant
+struct ControlInput
+{
+	std::chrono::steady_clock::time_point time;
+	BodyHandle body;
+	forceVector control;
+	bool pressed;
+};
+
+// Immutable copy of the world published by the simulation thread. The render thread draws and
+// inspects it while the simulation goes on stepping its own bodies.
+struct WorldSnapshot
+{
+	BodyStore bodies;
+	// Every body after every step later than the step of the snapshot the reader had acquired when this one
+	// was written, in step order. Steps the reader acquired meanwhile come again, so it skips steps it has seen.
+	// At most the last SAMPLE_BACKLOG_STEPS steps: the older ones are dropped if the reader falls further behind.
+	std::vector<TrajectorySample> samples;
+
+	// Steps taken since the start, and the simulated time they cover, s
+	std::uint64_t steps = 0;
+	double simulatedTime = 0.0;
+
+	// Time step, and how far the simulation clock was past the last step when the snapshot was taken
+	float fixedDeltaTime = 0.0f;
+	float interpolationFactor = 0.0f;
+	std::chrono::steady_clock::time_point publishTime;
+	bool paused = false;
+
+	// Steps per second of wall time, and wall time per step, ms, over the last measurement interval
+	double stepRate = 0.0;
+	double stepTime = 0.0;
+
+	// Statistics of the Hermite integrator, while it is the one selected
+	bool hermite = false;
+	HermiteStatistics hermiteStatistics;
+
+	// Total energy, J, after the given step, once SimulationThread::measureEnergy() was called
+	bool energyMeasured = false;
+	double totalEnergy = 0.0;
+	std::uint64_t energyStep = 0;
+
+	// Snapshots published so far, this one included
+	std::uint64_t publication = 0;
+
+	// Render time between the previous (0) and the current (1) state of the bodies: the clock keeps
+	// running after the snapshot was taken, so the bodies keep moving until the next one arrives
+	float getInterpolationFactor(const std::chrono::steady_clock::time_point& now) const;
+};
+
+// Runs a World on a thread of its own, in fixed steps at the pace of the wall clock.
+// After every batch of steps the world is copied into a snapshot and handed to the render thread through a
+// lock-free triple buffer, so neither side ever waits for the other and frame time and step rate are independent.
+// Every change to the world goes the other way, as a command queued for the simulation thread, which runs the
+// commands between steps. Keyboard controls take a faster lane: presses and releases go through a lock-free queue
+// with the time they happened, and each step applies a held control for the part of the step it was held.
+class SimulationThread
+{
+public:
+	typedef std::function<void(World&)> Command;
+	// Hands the result of a request back to the reader, on the reader's thread
+	typedef std::function<void()> Completion;
+	typedef std::function<Completion(World&)> Request;
+
+	explicit SimulationThread(World& world, const SimulationClock& clock = SimulationClock());
+	~SimulationThread();
+
+	SimulationThread(const SimulationThread&) = delete;
+	SimulationThread& operator=(const SimulationThread&) = delete;
+
+	void start();
+	// Runs the queued commands and joins the thread
+	void stop();
+
+	// Queues the command and returns at once
+	void post(const Command& command);
+	// Queues the request and returns at once. The completion it returns runs in the first acquire() whose snapshot
+	// shows the effect of the request, so results come back without waiting for the simulation thread.
+	void request(const Request& request);
+	// Queues the command and returns once it has run. The caller waits for the steps in progress, so this is for
+	// tests and shutdown; the render thread uses post() and request(). Runs it inline if the thread is stopped.
+	void execute(const Command& command);
+
+	// Evaluates the total energy between steps; it comes with every snapshot from then on
+	void measureEnergy();
+
+	// Input thread only; false if the queue is full and the input was dropped
+	bool pushControl(const ControlInput& input) { return controlInputs.push(input); }
+
+	void setPaused(const bool& paused);
+	void setTimeStep(const float& fixedDeltaTime, const int& maxSubsteps);
+
+	// Render thread: takes the latest snapshot if a new one was published and runs the completions it shows;
+	// false if getSnapshot() is still the latest
+	bool acquire();
+	const WorldSnapshot& getSnapshot() const { return snapshots.getFrontBuffer(); }
+
+	// While the thread is stopped: does what a round of the thread does, on the calling thread and with now as the
+	// wall clock time. Runs the queued commands, takes the steps due by now and publishes. The first call only starts
+	// the clock. Step and control timing are exact, independent of scheduling, e.g. for tests.
+	void advanceTo(const std::chrono::steady_clock::time_point& now);
+
+private:
+	void run();
+	// Runs the commands and empties batch; false if there were none
+	bool runCommands(std::vector<Command>& batch);
+	// Takes the steps due by now, or none while paused; true if there is something new to publish
+	bool update(const bool& pause, const std::chrono::steady_clock::time_point& now);
+	// Steps due by now, recording the samples
+	int advance(const std::chrono::steady_clock::time_point& now);
+	// Applies the controls held during the step that ends at stepEnd
+	void applyControls(const std::chrono::steady_clock::time_point& stepEnd);
+	void publish();
+
+private:
+	World& world;
+
+	std::thread thread;
+	bool running = false;
+
+	// Shared with the other threads under mutex
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::vector<Command> commands;
+	bool stopping = false;
+	bool paused = false;
+	SimulationClock requestedClock;
+	// Completions of the requests that have run, oldest first, with the first publication that shows their effect
+	std::vector<std::pair<std::uint64_t, Completion>> completions;
+
+	// Simulation thread only
+	SimulationClock clock;
+	bool clockStarted = false;
+	std::chrono::steady_clock::time_point lastAdvance;
+	bool stepping = true;
+	std::uint64_t steps = 0;
+	double simulatedTime = 0.0;
+	// Samples of the latest steps the reader has not acquired yet
+	std::vector<TrajectorySample> pendingSamples;
+	std::chrono::steady_clock::time_point rateStart;
+	std::uint64_t rateSteps = 0;
+	double rateStepSeconds = 0.0;
+	double stepRate = 0.0;
+	double stepTime = 0.0;
+	std::uint64_t publications = 0;
+	bool energyMeasured = false;
+	double totalEnergy = 0.0;
+	std::uint64_t energyStep = 0;
+
+	// Control inputs not applied yet, oldest first, and the controls held with the time they are applied up to
+	SpscQueue<ControlInput> controlInputs{ CONTROL_INPUT_CAPACITY };
+	std::deque<ControlInput> pendingControls;
+	std::vector<ControlInput> heldControls;
+
+	TripleBuffer<WorldSnapshot> snapshots;
+	// Step of the snapshot the reader acquired last
+	std::atomic<std::uint64_t> acquiredStep{ 0 };
+};
@@ -0,0 +1,61 @@
+#include "SlotMap.h"
+
+SlotHandle SlotMap::insert()
+{
+	std::uint32_t slot = firstFreeSlot;
+	if (slot != NULL_SLOT)
+		firstFreeSlot = slots[slot].index;
+	else
+	{
+		slot = static_cast<std::uint32_t>(slots.size());
+		slots.push_back({ 0, 0, false });
+	}
+
+	slots[slot].index = static_cast<std::uint32_t>(indexToSlot.size());
+	slots[slot].live = true;
+	indexToSlot.push_back(slot);
+
+	SlotHandle handle;
+	handle.slot = slot;
+	handle.generation = slots[slot].generation;
+	return handle;
+}
+
+std::size_t SlotMap::erase(const SlotHandle& handle)
+{
+	if (!contains(handle))
+		return NO_INDEX;
+
+	Slot& erased = slots[handle.slot];
+	const std::size_t index = erased.index;
+
+	// The last element moves into the hole
+	const std::uint32_t lastSlot = indexToSlot.back();
+	slots[lastSlot].index = static_cast<std::uint32_t>(index);
+	indexToSlot[index] = lastSlot;
+	indexToSlot.pop_back();
+
+	++erased.generation;
+	erased.live = false;
+	erased.index = firstFreeSlot;
+	firstFreeSlot = handle.slot;
+
+	return index;
+}
+
+void SlotMap::permute(const std::vector<std::size_t>& order)
+{
+	std::vector<std::uint32_t> permuted(order.size());
+	for (std::size_t k = 0; k < order.size(); ++k)
+	{
+		permuted[k] = indexToSlot[order[k]];
+		slots[permuted[k]].index = static_cast<std::uint32_t>(k);
+	}
+	indexToSlot.swap(permuted);
+}
+
+void SlotMap::clear()
+{
+	while (!indexToSlot.empty())
+		erase(handleOf(indexToSlot.size() - 1));
+}
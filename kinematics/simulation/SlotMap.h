@@ -0,0 +1,67 @@
+#pragma once
+
+// Std. Includes
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#define NULL_SLOT 0xFFFFFFFFu
+#define NO_INDEX static_cast<std::size_t>(-1)
+
+// Reference to an element of a SlotMap. It stays valid while other elements are inserted, erased or
+// reordered, and goes stale for good once its own element is erased.
+struct SlotHandle
+{
+	std::uint32_t slot = NULL_SLOT;
+	std::uint32_t generation = 0;
+
+	bool operator==(const SlotHandle& other) const { return slot == other.slot && generation == other.generation; }
+	bool operator!=(const SlotHandle& other) const { return !(*this == other); }
+};
+
+// Maps handles to the indices of elements kept densely in arrays owned by the caller.
+// Every handle names a slot and the generation the slot had when the handle was issued; a slot points at the
+// element's index, and its generation is bumped when the element is erased, so reusing the slot never makes an
+// old handle point at a new element. The caller mirrors every change on its arrays: insert() is a push_back,
+// erase() moves the last element into the hole, and permute() reorders like the order it is given.
+class SlotMap
+{
+public:
+	std::size_t size() const { return indexToSlot.size(); }
+
+	// Handle of a new element at index size()
+	SlotHandle insert();
+	// Returns the index the element had, which the last element now takes; NO_INDEX for a stale handle
+	std::size_t erase(const SlotHandle& handle);
+	// Element k becomes the one that was at order[k]; order must be a permutation of 0 .. size() - 1
+	void permute(const std::vector<std::size_t>& order);
+	// Erases every element
+	void clear();
+
+	bool contains(const SlotHandle& handle) const
+	{
+		return handle.slot < slots.size() && slots[handle.slot].generation == handle.generation && slots[handle.slot].live;
+	}
+	// NO_INDEX for a stale handle
+	std::size_t indexOf(const SlotHandle& handle) const { return contains(handle) ? slots[handle.slot].index : NO_INDEX; }
+	SlotHandle handleOf(const std::size_t& index) const
+	{
+		SlotHandle handle;
+		handle.slot = indexToSlot[index];
+		handle.generation = slots[handle.slot].generation;
+		return handle;
+	}
+
+private:
+	struct Slot
+	{
+		// Index of the element while live, next free slot otherwise
+		std::uint32_t index;
+		std::uint32_t generation;
+		bool live;
+	};
+
+	std::vector<Slot> slots;
+	std::vector<std::uint32_t> indexToSlot;
+	std::uint32_t firstFreeSlot = NULL_SLOT;
+};
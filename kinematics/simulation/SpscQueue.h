@@ -0,0 +1,82 @@
+#pragma once
+
+// Std. Includes
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#define CACHE_LINE_SIZE 64
+
+// Bounded lock-free queue from exactly one producer thread to exactly one consumer thread.
+// A ring of a power-of-two size with a head only the consumer advances and a tail only the producer advances.
+// Each side keeps its own copy of the other side's index and only reloads it when the ring looks full or
+// empty, so in the common case a push or a pop touches no cache line written by the other thread.
+template <class T>
+class SpscQueue
+{
+public:
+	// Holds at least capacity values
+	explicit SpscQueue(const std::size_t& capacity)
+		: buffer(roundUpToPowerOfTwo(capacity)), mask(buffer.size() - 1)
+	{
+
+	}
+
+	SpscQueue(const SpscQueue&) = delete;
+	SpscQueue& operator=(const SpscQueue&) = delete;
+
+	// Producer: false if the queue is full, in which case nothing is added
+	bool push(const T& value)
+	{
+		const std::size_t tail = this->tail.load(std::memory_order_relaxed);
+		if (tail - producerHead == buffer.size())
+		{
+			producerHead = head.load(std::memory_order_acquire);
+			if (tail - producerHead == buffer.size())
+				return false;
+		}
+
+		buffer[tail & mask] = value;
+		this->tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer: false if the queue is empty
+	bool pop(T& value)
+	{
+		const std::size_t head = this->head.load(std::memory_order_relaxed);
+		if (head == consumerTail)
+		{
+			consumerTail = tail.load(std::memory_order_acquire);
+			if (head == consumerTail)
+				return false;
+		}
+
+		value = buffer[head & mask];
+		this->head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	std::size_t capacity() const { return buffer.size(); }
+
+private:
+	static std::size_t roundUpToPowerOfTwo(const std::size_t& value)
+	{
+		std::size_t size = 1;
+		while (size < value)
+			size <<= 1;
+		return size;
+	}
+
+private:
+	std::vector<T> buffer;
+	const std::size_t mask;
+
+	// Consumer side
+	alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head{ 0 };
+	std::size_t consumerTail = 0;
+
+	// Producer side
+	alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail{ 0 };
+	std::size_t producerHead = 0;
+};
@@ -0,0 +1,173 @@
+#include "ThreadPool.h"
+
+// Std. Includes
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+{
+	start(threadCount);
+}
+
+ThreadPool::~ThreadPool()
+{
+	stop();
+}
+
+void ThreadPool::resize(unsigned int threadCount)
+{
+	if (threadCount < 1)
+		threadCount = 1;
+
+	if (threadCount == getThreadCount())
+		return;
+
+	stop();
+	start(threadCount);
+}
+
+unsigned int ThreadPool::getHardwareThreadCount()
+{
+	const unsigned int count = std::thread::hardware_concurrency();
+	return count > 0 ? count : 1;
+}
+
+void ThreadPool::start(unsigned int threadCount)
+{
+	if (threadCount < 1)
+		threadCount = 1;
+
+	stopping = false;
+
+	queues.clear();
+	for (unsigned int i = 0; i < threadCount; ++i)
+		queues.push_back(std::unique_ptr<Queue>(new Queue()));
+
+	// Queue 0 belongs to the thread calling parallelFor()
+	for (unsigned int i = 1; i < threadCount; ++i)
+		workers.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+}
+
+void ThreadPool::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(wakeMutex);
+		stopping = true;
+	}
+	wake.notify_all();
+
+	for (std::thread& worker : workers)
+		worker.join();
+
+	workers.clear();
+}
+
+void ThreadPool::parallelFor(
+	std::size_t begin,
+	std::size_t end,
+	std::size_t grainSize,
+	const std::function<void(std::size_t, std::size_t)>& task)
+{
+	if (begin >= end)
+		return;
+
+	grainSize = std::max<std::size_t>(grainSize, 1);
+
+	if (workers.empty() || end - begin <= grainSize)
+	{
+		task(begin, end);
+		return;
+	}
+
+	const std::size_t chunkCount = (end - begin + grainSize - 1) / grainSize;
+
+	this->task = &task;
+	pendingChunks.store(chunkCount);
+
+	// Deal the chunks out in contiguous blocks, so each thread starts on neighbouring bodies
+	const std::size_t threadCount = queues.size();
+	for (std::size_t thread = 0; thread < threadCount; ++thread)
+	{
+		const std::size_t firstChunk = chunkCount * thread / threadCount;
+		const std::size_t lastChunk = chunkCount * (thread + 1) / threadCount;
+
+		std::lock_guard<std::mutex> lock(queues[thread]->mutex);
+		for (std::size_t chunk = firstChunk; chunk < lastChunk; ++chunk)
+		{
+			const std::size_t chunkBegin = begin + chunk * grainSize;
+			queues[thread]->chunks.push_back({ chunkBegin, std::min(chunkBegin + grainSize, end) });
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(wakeMutex);
+		++generation;
+	}
+	wake.notify_all();
+
+	while (pendingChunks.load() > 0)
+		if (!runChunk(0))
+			std::this_thread::yield();
+
+	this->task = nullptr;
+}
+
+void ThreadPool::workerLoop(unsigned int index)
+{
+	std::size_t seenGeneration = 0;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(wakeMutex);
+			wake.wait(lock, [&] { return stopping || generation != seenGeneration; });
+
+			if (stopping)
+				return;
+
+			seenGeneration = generation;
+		}
+
+		while (pendingChunks.load() > 0)
+			if (!runChunk(index))
+				std::this_thread::yield();
+	}
+}
+
+bool ThreadPool::runChunk(unsigned int index)
+{
+	Chunk chunk;
+	bool found = false;
+
+	// Own queue: newest first
+	{
+		Queue& own = *queues[index];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.chunks.empty())
+		{
+			chunk = own.chunks.back();
+			own.chunks.pop_back();
+			found = true;
+		}
+	}
+
+	// Steal the oldest chunk of another thread
+	for (std::size_t offset = 1; !found && offset < queues.size(); ++offset)
+	{
+		Queue& victim = *queues[(index + offset) % queues.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.chunks.empty())
+		{
+			chunk = victim.chunks.front();
+			victim.chunks.pop_front();
+			found = true;
+		}
+	}
+
+	if (!found)
+		return false;
+
+	(*task)(chunk.begin, chunk.end);
+	pendingChunks.fetch_sub(1);
+
+	return true;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+// Std. Includes
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent pool of worker threads for data-parallel loops.
+// parallelFor() cuts the index range into chunks and deals them out to per-thread deques; a thread pops
+// its own chunks from the back and, once it runs dry, steals from the front of the others.
+// The calling thread works as thread 0, so a pool of one thread runs everything inline.
+class ThreadPool
+{
+public:
+	explicit ThreadPool(unsigned int threadCount = 1);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// Joins the current workers and starts new ones
+	void resize(unsigned int threadCount);
+	unsigned int getThreadCount() const { return static_cast<unsigned int>(queues.size()); }
+
+	// Calls task(chunkBegin, chunkEnd) over [begin, end) in chunks of at most grainSize and returns when all are done.
+	// Chunks may run in any order on any thread, so task must only write data owned by its own indices.
+	void parallelFor(
+		std::size_t begin,
+		std::size_t end,
+		std::size_t grainSize,
+		const std::function<void(std::size_t, std::size_t)>& task
+	);
+
+	static unsigned int getHardwareThreadCount();
+
+private:
+	struct Chunk
+	{
+		std::size_t begin, end;
+	};
+
+	struct Queue
+	{
+		std::mutex mutex;
+		std::deque<Chunk> chunks;
+	};
+
+	void start(unsigned int threadCount);
+	void stop();
+
+	void workerLoop(unsigned int index);
+	// Runs one chunk from the own queue or a stolen one; false if every queue was empty
+	bool runChunk(unsigned int index);
+
+private:
+	std::vector<std::thread> workers;
+	std::vector<std::unique_ptr<Queue>> queues;
+
+	const std::function<void(std::size_t, std::size_t)>* task = nullptr;
+	std::atomic<std::size_t> pendingChunks{ 0 };
+
+	std::mutex wakeMutex;
+	std::condition_variable wake;
+	std::size_t generation = 0;
+	bool stopping = false;
+};
@@ -0,0 +1,204 @@
+#include "Trajectory.h"
+
+// Std. Includes
+#include <algorithm>
+#include <utility>
+
+// GLM
+#include <glm/glm/geometric.hpp>
+
+namespace
+{
+	// Escalations of the archive tolerance before the oldest history is dropped instead
+	const int MAX_ARCHIVE_SIMPLIFICATIONS = 16;
+
+	float distanceToSegment(const glm::vec3& point, const glm::vec3& a, const glm::vec3& b)
+	{
+		const glm::vec3 segment = b - a;
+		const float lengthSquared = glm::dot(segment, segment);
+		if (lengthSquared == 0.0f)
+			return glm::length(point - a);
+
+		const float t = glm::clamp(glm::dot(point - a, segment) / lengthSquared, 0.0f, 1.0f);
+		return glm::length(point - (a + t * segment));
+	}
+}
+
+Trajectory::Trajectory(const std::size_t& memoryBudget, const float& tolerance)
+	: memoryBudget(memoryBudget), tolerance(tolerance), archiveTolerance(tolerance)
+{
+
+}
+
+void Trajectory::append(const glm::vec3& point)
+{
+	if (recentCount >= getRecentCapacity())
+		compactRecent();
+	else if (recent.capacity() < getRecentCapacity())
+		recent.reserve(getRecentCapacity());
+
+	// The ring grows until it reaches its capacity, then wraps around
+	if (recentBegin == 0 && recentCount == recent.size())
+		recent.push_back(point);
+	else
+		recent[(recentBegin + recentCount) % recent.size()] = point;
+
+	++recentCount;
+}
+
+void Trajectory::clear()
+{
+	std::vector<glm::vec3>().swap(recent);
+	std::vector<glm::vec3>().swap(archive);
+	recentBegin = 0;
+	recentCount = 0;
+	archiveTolerance = tolerance;
+	++revision;
+}
+
+void Trajectory::setMemoryBudget(const std::size_t& memoryBudget)
+{
+	this->memoryBudget = memoryBudget;
+
+	while (recentCount >= getRecentCapacity())
+		compactRecent();
+
+	// Straighten the ring, so that it grows or wraps at the new capacity
+	std::vector<glm::vec3> points(recentCount);
+	for (std::size_t k = 0; k < recentCount; ++k)
+		points[k] = getRecent(k);
+	recent.swap(points);
+	recentBegin = 0;
+
+	recent.shrink_to_fit();
+	archive.shrink_to_fit();
+}
+
+void Trajectory::setTolerance(const float& tolerance)
+{
+	this->tolerance = tolerance;
+
+	// Coarser pieces raise the archive's tolerance right away; a finer one only applies to an empty archive
+	archiveTolerance = archive.empty() ? tolerance : std::max(archiveTolerance, tolerance);
+}
+
+void Trajectory::copyVertices(std::vector<float>& vertices, const std::size_t& firstPoint, const std::size_t& maxPoints) const
+{
+	const std::size_t pointCount = getPointCount();
+	const std::size_t endPoint = firstPoint < pointCount ? firstPoint + (maxPoints < pointCount - firstPoint ? maxPoints : pointCount - firstPoint) : firstPoint;
+	vertices.resize(3 * (endPoint - firstPoint));
+
+	std::size_t v = 0;
+	for (std::size_t k = firstPoint; k < archive.size() && k < endPoint; ++k)
+	{
+		vertices[v++] = archive[k].x;
+		vertices[v++] = archive[k].y;
+		vertices[v++] = archive[k].z;
+	}
+	for (std::size_t k = firstPoint > archive.size() ? firstPoint - archive.size() : 0; archive.size() + k < endPoint; ++k)
+	{
+		const glm::vec3& point = getRecent(k);
+		vertices[v++] = point.x;
+		vertices[v++] = point.y;
+		vertices[v++] = point.z;
+	}
+}
+
+std::size_t Trajectory::getMemoryUsage() const
+{
+	return (recent.capacity() + archive.capacity()) * sizeof(glm::vec3);
+}
+
+std::size_t Trajectory::getRecentCapacity() const
+{
+	return std::max<std::size_t>(4, memoryBudget / 3 / sizeof(glm::vec3));
+}
+
+std::size_t Trajectory::getArchiveCapacity() const
+{
+	return std::max<std::size_t>(4, memoryBudget / 2 / sizeof(glm::vec3));
+}
+
+void Trajectory::compactRecent()
+{
+	const std::size_t moved = recentCount / 2;
+	if (moved == 0)
+		return;
+
+	// Room for a full archive plus one incoming half of the ring, reserved once so appending never reallocates
+	const std::size_t archiveReserve = getArchiveCapacity() + getRecentCapacity() / 2 + 1;
+	if (archive.capacity() < archiveReserve)
+		archive.reserve(archiveReserve);
+
+	// The last archived point anchors the new piece, so the joint may be simplified as well
+	const std::size_t begin = archive.empty() ? 0 : archive.size() - 1;
+	for (std::size_t k = 0; k < moved; ++k)
+		archive.push_back(getRecent(k));
+	simplify(archive, begin, tolerance);
+
+	recentBegin = (recentBegin + moved) % recent.size();
+	recentCount -= moved;
+	++revision;
+
+	// Over budget: coarsen the whole archive down to half of its capacity, so that the next pieces fit without
+	// another pass. The last tolerance is tried first and only doubled when it does not free enough points.
+	if (archive.size() > getArchiveCapacity())
+	{
+		simplify(archive, 0, archiveTolerance);
+		for (int pass = 0; archive.size() > getArchiveCapacity() / 2 && pass < MAX_ARCHIVE_SIMPLIFICATIONS; ++pass)
+		{
+			archiveTolerance *= 2.0f;
+			simplify(archive, 0, archiveTolerance);
+		}
+	}
+
+	// Still over budget: the oldest history goes
+	if (archive.size() > getArchiveCapacity())
+		archive.erase(archive.begin(), archive.begin() + (archive.size() - getArchiveCapacity()));
+}
+
+void Trajectory::simplify(std::vector<glm::vec3>& points, const std::size_t& begin, const float& tolerance)
+{
+	const std::size_t count = points.size() - begin;
+	if (count <= 2)
+		return;
+
+	std::vector<unsigned char> keep(count, 0);
+	keep[0] = 1;
+	keep[count - 1] = 1;
+
+	std::vector<std::pair<std::size_t, std::size_t>> segments;
+	segments.push_back(std::make_pair(std::size_t(0), count - 1));
+
+	while (!segments.empty())
+	{
+		const std::size_t first = segments.back().first;
+		const std::size_t last = segments.back().second;
+		segments.pop_back();
+
+		float maxDistance = 0.0f;
+		std::size_t farthest = first;
+		for (std::size_t k = first + 1; k < last; ++k)
+		{
+			const float distance = distanceToSegment(points[begin + k], points[begin + first], points[begin + last]);
+			if (distance > maxDistance)
+			{
+				maxDistance = distance;
+				farthest = k;
+			}
+		}
+
+		if (maxDistance > tolerance)
+		{
+			keep[farthest] = 1;
+			segments.push_back(std::make_pair(first, farthest));
+			segments.push_back(std::make_pair(farthest, last));
+		}
+	}
+
+	std::size_t write = begin;
+	for (std::size_t k = 0; k < count; ++k)
+		if (keep[k])
+			points[write++] = points[begin + k];
+	points.resize(write);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+// Std. Includes
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// GLM
+#include <glm/glm/vec3.hpp>
+
+#define DEFAULT_TRAJECTORY_MEMORY_BUDGET (64 * 1024)
+#define DEFAULT_TRAJECTORY_TOLERANCE 0.01f
+
+// Trajectory of one body within a fixed memory budget.
+// Recent points are kept exactly in a ring buffer that takes a third of the budget. When it fills up, its older
+// half is simplified (Douglas-Peucker: every dropped point lies within the tolerance of the kept polyline)
+// and moved to the archive, which holds half of the budget plus room for one incoming piece. If the archive
+// outgrows it, the whole archive is simplified again, doubling the tolerance until half of it is free, so the
+// error of old history grows instead of the memory.
+class Trajectory
+{
+public:
+	Trajectory(const std::size_t& memoryBudget = DEFAULT_TRAJECTORY_MEMORY_BUDGET, const float& tolerance = DEFAULT_TRAJECTORY_TOLERANCE);
+
+	void append(const glm::vec3& point);
+	void clear();
+
+	// Bytes per body and the error bound of the first compaction, m; both apply from the next compaction
+	void setMemoryBudget(const std::size_t& memoryBudget);
+	void setTolerance(const float& tolerance);
+
+	// The polyline from point firstPoint (0 being the oldest) as x, y, z triples, up to maxPoints of them
+	void copyVertices(std::vector<float>& vertices, const std::size_t& firstPoint = 0, const std::size_t& maxPoints = SIZE_MAX) const;
+
+	// Changes whenever points already in the polyline are moved or dropped; appending keeps it,
+	// so a copy with the same revision only lacks the points past its own count
+	std::uint64_t getRevision() const { return revision; }
+
+	std::size_t getPointCount() const { return archive.size() + recentCount; }
+	std::size_t getRecentPointCount() const { return recentCount; }
+	std::size_t getArchivedPointCount() const { return archive.size(); }
+	// Bytes held by the point buffers
+	std::size_t getMemoryUsage() const;
+	std::size_t getMemoryBudget() const { return memoryBudget; }
+	// Tolerance the archive was last simplified with, m. Dropped points lie about this far from the archived
+	// polyline at most; repeated passes may add a little on top.
+	float getArchiveTolerance() const { return archiveTolerance; }
+
+private:
+	// Recent point k, 0 being the oldest one
+	const glm::vec3& getRecent(const std::size_t& k) const { return recent[(recentBegin + k) % recent.size()]; }
+
+	// Moves the older half of the ring buffer into the archive
+	void compactRecent();
+	// Keeps the points from begin to the end of points whose removal would move the polyline by more than
+	// tolerance. Both end points of the range are always kept; points shrinks to the result.
+	static void simplify(std::vector<glm::vec3>& points, const std::size_t& begin, const float& tolerance);
+
+	std::size_t getRecentCapacity() const;
+	std::size_t getArchiveCapacity() const;
+
+private:
+	std::size_t memoryBudget;
+	float tolerance;
+	// Tolerance of the last whole-archive pass
+	float archiveTolerance;
+
+	// Ring buffer; grows up to its capacity, then wraps
+	std::vector<glm::vec3> recent;
+	std::size_t recentBegin = 0;
+	std::size_t recentCount = 0;
+
+	std::vector<glm::vec3> archive;
+
+	std::uint64_t revision = 0;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+// Std. Includes
+#include <atomic>
+#include <cstdint>
+
+// Lock-free hand-over of whole values from one writer thread to one reader thread.
+// The writer fills the back buffer and publishes it; the reader takes the latest published buffer as its front.
+// Neither side ever waits for the other: the third buffer sits in the middle, and publishing or acquiring is a
+// single atomic exchange with it. A value the reader has not taken yet is replaced by the next one.
+template <class T>
+class TripleBuffer
+{
+public:
+	TripleBuffer()
+		: front(0), middle(1), back(2)
+	{
+
+	}
+
+	TripleBuffer(const TripleBuffer&) = delete;
+	TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+	// Writer: the buffer to fill next. It holds whatever was written to it last, not the latest value.
+	T& getBackBuffer() { return buffers[back]; }
+
+	// Writer: makes the back buffer the latest value. Returns false when the value published before
+	// was never acquired and has been skipped; its buffer is the new back buffer.
+	bool publish()
+	{
+		const std::uint8_t previous = middle.exchange(back | FRESH, std::memory_order_acq_rel);
+		back = previous & INDEX;
+		return (previous & FRESH) == 0;
+	}
+
+	// Reader: takes the latest value if one was published since the last call; false if the front is still the latest
+	bool acquire()
+	{
+		if ((middle.load(std::memory_order_relaxed) & FRESH) == 0)
+			return false;
+
+		front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+		return true;
+	}
+
+	// Reader: the value acquired last
+	const T& getFrontBuffer() const { return buffers[front]; }
+	T& getFrontBuffer() { return buffers[front]; }
+
+private:
+	static const std::uint8_t INDEX = 0x3;
+	// Set while the middle buffer holds a value the reader has not acquired
+	static const std::uint8_t FRESH = 0x4;
+
+	T buffers[3];
+
+	// Owned by the reader and the writer respectively
+	std::uint8_t front;
+	std::atomic<std::uint8_t> middle;
+	std::uint8_t back;
+};
@@ -0,0 +1,233 @@
+#include "World.h"
+
+// Std. Includes
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+// GLM
+#include <glm/glm/geometric.hpp>
+
+// Classes
+#include "ForceModels.h"
+#include "Integrator.h"
+#include "Profiler.h"
+
+namespace
+{
+	// Whether both options give every body the same forces
+	bool haveSameForces(const WorldOptions& a, const WorldOptions& b)
+	{
+		return a.typeOfSpace == b.typeOfSpace && a.ambientDensity == b.ambientDensity &&
+			a.gravitySolver == b.gravitySolver && a.openingAngle == b.openingAngle &&
+			a.softeningLength == b.softeningLength && a.simdLevel == b.simdLevel &&
+			a.astronomicalObjectMass == b.astronomicalObjectMass && a.astronomicalObjectRadius == b.astronomicalObjectRadius &&
+			a.astronomicalObjectAverageSoilDensity == b.astronomicalObjectAverageSoilDensity;
+	}
+}
+
+template <class Precision>
+BasicWorld<Precision>::BasicWorld() : forceModel(selectForceModel<Precision>(options)), integrator(createIntegrator<Precision>(options.integrator)), integratorType(options.integrator)
+{
+
+}
+
+template <class Precision>
+BasicWorld<Precision>::BasicWorld(const WorldOptions& options) : options(options), forceModel(selectForceModel<Precision>(options)), integrator(createIntegrator<Precision>(options.integrator)), integratorType(options.integrator)
+{
+
+}
+
+template <class Precision>
+BasicWorld<Precision>::~BasicWorld()
+{
+
+}
+
+template <class Precision>
+void BasicWorld<Precision>::step(const float& dt)
+{
+	PROFILE_SCOPE("Step");
+
+	gravityKernel = getGravityKernel(options.simdLevel);
+	forceModel = selectForceModel<Precision>(options);
+	threadPool.resize(options.threadCount);
+
+	// Forces kept from the last step are stale once the options change them
+	if (!haveSameForces(options, steppedOptions))
+		bodyStore.markEdited();
+	steppedOptions = options;
+
+	if (options.integrator != integratorType)
+	{
+		integrator = createIntegrator<Precision>(options.integrator);
+		integratorType = options.integrator;
+	}
+
+	// Reads current() (step n), writes next() (step n + 1)
+	integrator->step(*this, dt);
+
+	bodyStore.swapStates();
+}
+
+template <class Precision>
+void BasicWorld<Precision>::parallelForBodies(const std::function<void(std::size_t, std::size_t)>& task)
+{
+	parallelFor(bodyStore.size(), task);
+}
+
+template <class Precision>
+void BasicWorld<Precision>::parallelFor(const std::size_t& count, const std::function<void(std::size_t, std::size_t)>& task)
+{
+	const std::size_t grainSize = std::max<std::size_t>(16, count / (8 * threadPool.getThreadCount()));
+
+	threadPool.parallelFor(0, count, grainSize, task);
+}
+
+template <class Precision>
+void BasicWorld<Precision>::computeAccelerations(const State& state)
+{
+	// Pass 1: mutual gravity. Nobody writes the state during the pass, so the result
+	// does not depend on body order or on how the work is split between threads.
+	if (options.typeOfSpace == EMPTY_SPACE)
+	{
+		PROFILE_SCOPE("Gravity");
+
+		const Vector3Array& coordinates = getGravityCoordinates(state);
+
+		// The tree is rebuilt for every evaluated state
+		if (options.gravitySolver == BARNES_HUT)
+			octree.build(coordinates, bodyStore.mass);
+
+		parallelForBodies([this, &coordinates](std::size_t begin, std::size_t end) { computeGravitationalForces(coordinates, begin, end); });
+	}
+
+	// Pass 2: every body touches only its own data
+	PROFILE_SCOPE("Forces");
+	parallelForBodies([this, &state](std::size_t begin, std::size_t end) { forceModel(*this, state, begin, end); });
+}
+
+template <class Precision>
+const Vector3Array& BasicWorld<Precision>::getGravityCoordinates(const State& state)
+{
+	if constexpr (std::is_same<typename Precision::Position, float>::value)
+	{
+		return state.coordinates;
+	}
+	else
+	{
+		const std::size_t count = bodyStore.size();
+		gravityCoordinates.resize(count);
+		if (count == 0)
+			return gravityCoordinates;
+
+		// Centre of the bounding box, kept in the state's precision
+		const auto& x = state.coordinates.x;
+		const auto& y = state.coordinates.y;
+		const auto& z = state.coordinates.z;
+		std::size_t minimum[3] = { 0, 0, 0 };
+		std::size_t maximum[3] = { 0, 0, 0 };
+		for (std::size_t i = 1; i < count; ++i)
+		{
+			if (difference(x[i], x[minimum[0]]) < 0.0) minimum[0] = i;
+			if (difference(y[i], y[minimum[1]]) < 0.0) minimum[1] = i;
+			if (difference(z[i], z[minimum[2]]) < 0.0) minimum[2] = i;
+			if (difference(x[i], x[maximum[0]]) > 0.0) maximum[0] = i;
+			if (difference(y[i], y[maximum[1]]) > 0.0) maximum[1] = i;
+			if (difference(z[i], z[maximum[2]]) > 0.0) maximum[2] = i;
+		}
+		const typename Precision::Position origin[3] = {
+			displace(x[minimum[0]], 0.5 * difference(x[maximum[0]], x[minimum[0]])),
+			displace(y[minimum[1]], 0.5 * difference(y[maximum[1]], y[minimum[1]])),
+			displace(z[minimum[2]], 0.5 * difference(z[maximum[2]], z[minimum[2]]))
+		};
+
+		parallelForBodies([&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				gravityCoordinates.x[i] = static_cast<float>(difference(x[i], origin[0]));
+				gravityCoordinates.y[i] = static_cast<float>(difference(y[i], origin[1]));
+				gravityCoordinates.z[i] = static_cast<float>(difference(z[i], origin[2]));
+			}
+		});
+
+		return gravityCoordinates;
+	}
+}
+
+template <class Precision>
+void BasicWorld<Precision>::computeGravitationalForces(const Vector3Array& coordinates, const std::size_t& begin, const std::size_t& end)
+{
+	Store& b = bodyStore;
+	const float softeningSquared = options.softeningLength * options.softeningLength;
+
+	if (options.gravitySolver == BARNES_HUT)
+	{
+		for (std::size_t i = begin; i < end; ++i)
+			b.gravitationalForce.set(i, b.mass[i] * octree.computeAcceleration(coordinates, b.mass, coordinates.get(i), i, options.openingAngle, softeningSquared));
+		return;
+	}
+
+	const GravitySources sources = { coordinates.x.data(), coordinates.y.data(), coordinates.z.data(), b.mass.data(), b.size() };
+	gravityKernel(sources, begin, end, softeningSquared, &b.gravitationalForce.x[begin], &b.gravitationalForce.y[begin], &b.gravitationalForce.z[begin]);
+
+	for (std::size_t i = begin; i < end; ++i)
+	{
+		b.gravitationalForce.x[i] *= b.mass[i];
+		b.gravitationalForce.y[i] *= b.mass[i];
+		b.gravitationalForce.z[i] *= b.mass[i];
+	}
+}
+
+template <class Precision>
+void BasicWorld<Precision>::computeInstantCharachteristics(const State& state, const std::size_t& body)
+{
+	forceModel(*this, state, body, body + 1);
+}
+
+template <class Precision>
+double BasicWorld<Precision>::computeTotalEnergy() const
+{
+	const Store& b = bodyStore;
+	const auto& coordinates = b.current().coordinates;
+	const auto& velocity = b.current().velocity;
+	const double softeningSquared = static_cast<double>(options.softeningLength) * options.softeningLength;
+
+	double energy = 0.0;
+
+	for (std::size_t i = 0; i < b.size(); ++i)
+	{
+		const glm::dvec3 v = velocity.getDouble(i);
+		energy += 0.5 * b.mass[i] * glm::dot(v, v);
+
+		if (options.typeOfSpace == EMPTY_SPACE)
+		{
+			// U = -G * m_i * m_j / sqrt(r^2 + softening^2), every pair once
+			for (std::size_t j = i + 1; j < b.size(); ++j)
+			{
+				const double dx = difference(coordinates.x[j], coordinates.x[i]);
+				const double dy = difference(coordinates.y[j], coordinates.y[i]);
+				const double dz = difference(coordinates.z[j], coordinates.z[i]);
+				const double distance = std::sqrt(dx * dx + dy * dy + dz * dz + softeningSquared);
+
+				if (distance > 0.0)
+					energy -= GRAVITATIONAL_CONSTANT * static_cast<double>(b.mass[i]) * b.mass[j] / distance;
+			}
+		}
+		else
+		{
+			// U = -G * M * m / (R + h)
+			const double R = options.astronomicalObjectRadius;
+			const double h = toDouble(coordinates.y[i]);
+			if (R + h > 0.0)
+				energy -= GRAVITATIONAL_CONSTANT * static_cast<double>(options.astronomicalObjectMass) * b.mass[i] / (R + h);
+		}
+	}
+
+	return energy;
+}
+
+template class BasicWorld<SinglePrecision>;
+template class BasicWorld<DoublePrecision>;
+template class BasicWorld<FixedPointPrecision>;
@@ -0,0 +1,124 @@
+#pragma once
+
+// Std. Includes
+#include <functional>
+#include <memory>
+
+// Classes
+#include "BodyStore.h"
+#include "Gravity.h"
+#include "GravityKernels.h"
+#include "Octree.h"
+#include "ThreadPool.h"
+
+#define EMPTY_SPACE 0
+#define NEAR_AN_ASTRONOMICAL_OBJECT 1
+
+// Mutual gravity solvers (EMPTY_SPACE)
+#define DIRECT_SUM 0
+#define BARNES_HUT 1
+
+// Integrators
+#define SEMI_IMPLICIT_EULER 0
+#define LEAPFROG 1
+#define VELOCITY_VERLET 2
+#define YOSHIDA4 3
+#define HERMITE_BLOCK 4
+
+template <class Precision>
+class BasicIntegrator;
+template <class Precision>
+class BasicWorld;
+
+// World options
+struct WorldOptions
+{
+	int typeOfSpace = EMPTY_SPACE;
+	float ambientDensity = 0.0f;
+
+	int integrator = SEMI_IMPLICIT_EULER;
+
+	int gravitySolver = DIRECT_SUM;
+	// Barnes-Hut opening angle: smaller is more accurate and slower, 0 degenerates into the direct sum
+	float openingAngle = 0.5f;
+	// Plummer softening length, m: keeps close encounters finite and makes self-interaction vanish
+	float softeningLength = 0.01f;
+	// Highest instruction set the direct sum may use; the best one the CPU supports is picked at runtime
+	SimdLevel simdLevel = SIMD_AVX512;
+
+	// Threads stepping the world, including the calling one
+	unsigned int threadCount = ThreadPool::getHardwareThreadCount();
+
+	float astronomicalObjectMass = 0.0f;
+	float astronomicalObjectRadius = 0.0f;
+	float astronomicalObjectAverageSoilDensity = 0.0f;
+};
+
+// Non-gravitational forces and accelerations of bodies [begin, end) of the state for one configuration
+// of the world options. The instantiations live in ForceModels.h.
+template <class Precision>
+using BasicForceModel = void (*)(BasicWorld<Precision>& world, const BasicBodyState<Precision>& state, std::size_t begin, std::size_t end);
+
+// Headless simulation: owns the bodies and advances them in time.
+// Nothing here touches OpenGL, so it runs without a window or a GL context.
+// Precision is the policy the state is stored and integrated in (see Precision.h); forces are float in all of them.
+template <class Precision>
+class BasicWorld
+{
+public:
+	typedef BasicBodyStore<Precision> Store;
+	typedef BasicBodyState<Precision> State;
+
+	BasicWorld();
+	explicit BasicWorld(const WorldOptions& options);
+	~BasicWorld();
+
+	// Advances every body by dt seconds with the selected integrator
+	void step(const float& dt);
+
+	// Forces and accelerations of every body in the given state, written to bodies().acceleration
+	// and the force arrays. Integrators call it once per stage.
+	void computeAccelerations(const State& state);
+
+	// Runs task over chunks of the body range on the world's threads
+	void parallelForBodies(const std::function<void(std::size_t, std::size_t)>& task);
+	// Same over [0, count), for loops over a subset of the bodies
+	void parallelFor(const std::size_t& count, const std::function<void(std::size_t, std::size_t)>& task);
+
+	// Acceleration of one body in the given state from all forces but mutual gravity, which has to be
+	// in bodies().gravitationalForce already. Writes bodies().acceleration and the force arrays.
+	void computeInstantCharachteristics(const State& state, const std::size_t& body);
+
+	// Kinetic plus mutual gravitational potential energy of the current state, J
+	double computeTotalEnergy() const;
+
+	const BasicIntegrator<Precision>& getIntegrator() const { return *integrator; }
+
+	Store& bodies() { return bodyStore; }
+	const Store& bodies() const { return bodyStore; }
+
+public:
+	WorldOptions options;
+
+private:
+	// Single-precision coordinates the mutual gravity solvers work on: the state itself in single precision,
+	// otherwise the state relative to the centre of its bounding box, so only differences are rounded to float
+	const Vector3Array& getGravityCoordinates(const State& state);
+	// Mutual gravity of bodies [begin, end)
+	void computeGravitationalForces(const Vector3Array& coordinates, const std::size_t& begin, const std::size_t& end);
+
+private:
+	Store bodyStore;
+	Octree octree;
+	Vector3Array gravityCoordinates;
+	GravityKernel gravityKernel = gravityKernelScalar;
+	BasicForceModel<Precision> forceModel;
+	ThreadPool threadPool;
+
+	std::unique_ptr<BasicIntegrator<Precision>> integrator;
+	int integratorType;
+	// Options of the last step
+	WorldOptions steppedOptions;
+};
+
+typedef BasicWorld<SinglePrecision> World;
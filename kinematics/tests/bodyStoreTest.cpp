@@ -0,0 +1,136 @@
+// Body store handle test.
+// Runs random adds, removes, batch removes and reorders against a map of the bodies that should be alive,
+// and checks that every live handle finds its own body and that no removed handle finds any.
+
+// Std. Includes
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Classes
+#include "simulation/BodyStore.h"
+
+namespace
+{
+	struct LiveBody
+	{
+		BodyHandle handle;
+		float mass;
+	};
+
+	typedef std::vector<LiveBody> LiveBodies;
+
+	// Takes a random body out of live and returns its handle
+	BodyHandle takeRandom(LiveBodies& live, std::mt19937& generator)
+	{
+		const std::size_t body = generator() % live.size();
+		const BodyHandle handle = live[body].handle;
+		live[body] = live.back();
+		live.pop_back();
+		return handle;
+	}
+
+	bool isConsistent(const BodyStore& bodies, const LiveBodies& live, const std::vector<BodyHandle>& removed)
+	{
+		if (bodies.size() != live.size())
+		{
+			std::printf("%zu bodies stored, %zu expected\n", bodies.size(), live.size());
+			return false;
+		}
+
+		// Every body is added with its mass as its x coordinate, so both follow it through moves
+		for (const LiveBody& body : live)
+		{
+			const std::size_t i = bodies.indexOf(body.handle);
+			if (i == NO_INDEX || bodies.getHandle(i) != body.handle || bodies.mass[i] != body.mass || bodies.current().coordinates.get(i).x != body.mass)
+			{
+				std::printf("Live body of mass %g not found at its index\n", body.mass);
+				return false;
+			}
+		}
+
+		for (const BodyHandle& handle : removed)
+		{
+			if (bodies.contains(handle) || bodies.indexOf(handle) != NO_INDEX)
+			{
+				std::printf("Removed handle (%u, %u) still finds a body\n", handle.slot, handle.generation);
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+int main()
+{
+	const int operations = 200000;
+	const int checkInterval = 1000;
+
+	BodyStore bodies;
+	LiveBodies live;
+	std::vector<BodyHandle> removed;
+	std::mt19937 generator(1);
+	float nextMass = 1.0f;
+
+	for (int operation = 0; operation < operations; ++operation)
+	{
+		const unsigned int type = generator() % 100;
+		if (type < 64 || live.empty())
+		{
+			const BodyHandle handle = bodies.add(nextMass, 0.0f, 0.0f, glm::dvec3(nextMass, 0.0, 0.0));
+			if (bodies.indexOf(handle) != bodies.size() - 1)
+			{
+				std::printf("Operation %d: added body not at the end\n", operation);
+				return 1;
+			}
+			live.push_back({ handle, nextMass });
+			nextMass += 1.0f;
+		}
+		else if (type < 84)
+		{
+			removed.push_back(takeRandom(live, generator));
+			bodies.remove(removed.back());
+		}
+		else if (type == 84)
+		{
+			std::vector<std::size_t> order(bodies.size());
+			for (std::size_t i = 0; i < order.size(); ++i)
+				order[i] = i;
+			std::shuffle(order.begin(), order.end(), generator);
+			bodies.reorder(order);
+		}
+		else
+		{
+			std::vector<BodyHandle> batch;
+			for (int i = 0; i < 2 && !live.empty(); ++i)
+				batch.push_back(takeRandom(live, generator));
+			bodies.remove(batch);
+			removed.insert(removed.end(), batch.begin(), batch.end());
+		}
+
+		if (operation % checkInterval == 0 && !isConsistent(bodies, live, removed))
+		{
+			std::printf("Operation %d: inconsistent\n", operation);
+			return 1;
+		}
+	}
+
+	if (!isConsistent(bodies, live, removed))
+		return 1;
+
+	std::vector<BodyHandle> cleared;
+	for (const LiveBody& body : live)
+		cleared.push_back(body.handle);
+	bodies.clear();
+	live.clear();
+	if (!isConsistent(bodies, live, cleared))
+	{
+		std::printf("Handles still valid after clear()\n");
+		return 1;
+	}
+
+	std::printf("%d operations, %zu handles removed: OK\n", operations, removed.size() + cleared.size());
+	return 0;
+}
@@ -0,0 +1,107 @@
+// Control input test.
+// Checks that the control queue hands every value over once and in order, and that a force vector control held
+// for a given wall time changes the developed force by exactly that time, whatever the simulation step.
+// The timing is checked on a made-up clock through SimulationThread::advanceTo(), so it does not depend on scheduling.
+
+// Std. Includes
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+// Classes
+#include "simulation/SimulationThread.h"
+
+namespace
+{
+	bool testQueue()
+	{
+		const std::uint64_t values = 200000;
+
+		SpscQueue<std::uint64_t> queue(64);
+		std::uint64_t received = 0;
+		std::uint64_t misordered = 0;
+		std::thread consumer([&queue, &received, &misordered, values]()
+		{
+			std::uint64_t value;
+			while (received < values)
+			{
+				if (!queue.pop(value))
+				{
+					std::this_thread::yield();
+					continue;
+				}
+				if (value != received)
+					++misordered;
+				++received;
+			}
+		});
+
+		for (std::uint64_t value = 0; value < values;)
+		{
+			if (queue.push(value))
+				++value;
+			else
+				std::this_thread::yield();
+		}
+		consumer.join();
+
+		std::printf("Queue: %llu values received, %llu out of order\n", static_cast<unsigned long long>(received), static_cast<unsigned long long>(misordered));
+		return misordered == 0;
+	}
+
+	// Presses and releases at known instants on a made-up clock, taken in frames that do not line up with the steps.
+	// The inputs are pushed ahead of the frames that take them in, as the input thread pushes them when they happen.
+	bool testTiming(const float& fixedDeltaTime)
+	{
+		const std::chrono::milliseconds pressed(50);
+		const std::chrono::milliseconds increased(150);
+		const std::chrono::milliseconds released(550);
+		const std::chrono::milliseconds end(800);
+		const std::chrono::milliseconds frame(16);
+
+		World world;
+		const BodyHandle body = world.bodies().add(1.0f, 0.0f, 0.0f, glm::dvec3(0.0));
+
+		SimulationThread simulation(world, SimulationClock(fixedDeltaTime, 64));
+		const std::chrono::steady_clock::time_point start;
+		simulation.advanceTo(start);
+		simulation.acquire();
+		const std::uint64_t revision = simulation.getSnapshot().bodies.getRevision();
+
+		simulation.pushControl({ start + pressed, body, RAISE_DEVELOPED_FORCE_VECTOR, true });
+		simulation.pushControl({ start + increased, body, INCREASE_DEVELOPED_FORCE_VECTOR, true });
+		simulation.pushControl({ start + released, body, RAISE_DEVELOPED_FORCE_VECTOR, false });
+		simulation.pushControl({ start + released, body, INCREASE_DEVELOPED_FORCE_VECTOR, false });
+		for (std::chrono::milliseconds time = frame; time <= end; time += frame)
+			simulation.advanceTo(start + time);
+
+		simulation.acquire();
+		const BodyStore& bodies = simulation.getSnapshot().bodies;
+		const float theta = bodies.theta[bodies.indexOf(body)];
+		const float force = bodies.forceAbsValue[bodies.indexOf(body)];
+
+		const float expectedTheta = DEVELOPED_FORCE_ANGLE_RATE * std::chrono::duration<float>(released - pressed).count();
+		const float expectedForce = DEVELOPED_FORCE_RATE * std::chrono::duration<float>(released - increased).count();
+		std::printf("Timing at dt %g s: theta %.5f (%.5f expected), force %.5f (%.5f expected)\n",
+			fixedDeltaTime, theta, expectedTheta, force, expectedForce);
+
+		// Controls keep the forces the integrators carry over from one step to the next
+		if (bodies.getRevision() != revision)
+		{
+			std::printf("Timing at dt %g s: controls edited the bodies\n", fixedDeltaTime);
+			return false;
+		}
+		return std::fabs(theta - expectedTheta) <= 1.0e-4f * expectedTheta && std::fabs(force - expectedForce) <= 1.0e-4f * expectedForce;
+	}
+}
+
+int main()
+{
+	bool passed = testQueue();
+	for (const float fixedDeltaTime : { 0.001f, 0.01f, 0.05f })
+		passed &= testTiming(fixedDeltaTime);
+
+	std::printf(passed ? "OK\n" : "FAILED\n");
+	return passed ? 0 : 1;
+}
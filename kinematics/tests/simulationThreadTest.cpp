@@ -0,0 +1,150 @@
+// Simulation thread hand-over test.
+// Checks that the triple buffer hands whole values over in order, that a reader missing snapshots at random still
+// gets the trajectory sample of every body after every step, and that a stalled reader's backlog stays bounded.
+// The simulation is driven with advanceTo() on a made-up clock, so the sample checks do not depend on timing.
+
+// Std. Includes
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <thread>
+
+// Classes
+#include "simulation/SimulationThread.h"
+
+namespace
+{
+	// Value whose words are all written with the same number, so a torn copy shows
+	struct Stamp
+	{
+		std::uint64_t words[64] = {};
+	};
+
+	bool testTripleBuffer()
+	{
+		const std::uint64_t values = 200000;
+
+		TripleBuffer<Stamp> buffer;
+		std::thread writer([&buffer, values]()
+		{
+			for (std::uint64_t value = 1; value <= values; ++value)
+			{
+				for (std::uint64_t& word : buffer.getBackBuffer().words)
+					word = value;
+				buffer.publish();
+				if (value % 64 == 0)
+					std::this_thread::yield();
+			}
+		});
+
+		std::uint64_t last = 0;
+		std::uint64_t acquires = 0;
+		bool valid = true;
+		while (last < values && valid)
+		{
+			if (!buffer.acquire())
+			{
+				std::this_thread::yield();
+				continue;
+			}
+			++acquires;
+
+			const Stamp& stamp = buffer.getFrontBuffer();
+			for (const std::uint64_t& word : stamp.words)
+				valid &= word == stamp.words[0];
+			valid &= stamp.words[0] > last;
+			last = stamp.words[0];
+		}
+		writer.join();
+
+		if (!valid)
+			std::printf("Triple buffer: torn or stale value after %llu\n", static_cast<unsigned long long>(last));
+		else
+			std::printf("Triple buffer: %llu values published, %llu acquired\n", static_cast<unsigned long long>(values), static_cast<unsigned long long>(acquires));
+		return valid;
+	}
+
+	// Frames of random length on a made-up clock, so the steps taken are the same on every run
+	bool testSamples()
+	{
+		const int bodyCount = 100;
+		const int frames = 2000;
+
+		World world;
+		for (int i = 0; i < bodyCount; ++i)
+			world.bodies().add(1.0f, 0.0f, 0.0f, glm::dvec3(i, 0.0, 0.0));
+
+		SimulationThread simulation(world, SimulationClock(0.0005f, 64));
+		const std::chrono::steady_clock::time_point start;
+		std::chrono::steady_clock::duration time(0);
+		simulation.advanceTo(start);
+
+		// Last step seen of every body, by slot
+		std::map<std::uint32_t, std::uint64_t> lastSteps;
+		std::uint64_t appliedStep = 0;
+		std::size_t samples = 0;
+		int gaps = 0;
+		std::mt19937 generator(1);
+
+		for (int frame = 0; frame < frames; ++frame)
+		{
+			time += std::chrono::microseconds(generator() % 20000);
+			if (generator() % 10 == 0)
+				simulation.post([](World& simulated) { simulated.bodies().mass[0] = 2.0f; });
+			simulation.advanceTo(start + time);
+
+			// The reader misses most snapshots, though never for as long as the backlog
+			if (generator() % 4 != 0 || !simulation.acquire())
+				continue;
+
+			const WorldSnapshot& snapshot = simulation.getSnapshot();
+			for (const TrajectorySample& sample : snapshot.samples)
+			{
+				if (sample.step <= appliedStep)
+					continue;
+
+				const std::map<std::uint32_t, std::uint64_t>::iterator last = lastSteps.find(sample.body.slot);
+				if (last != lastSteps.end() && last->second + 1 != sample.step)
+					++gaps;
+				lastSteps[sample.body.slot] = sample.step;
+				++samples;
+			}
+			if (!snapshot.samples.empty() && snapshot.samples.back().step != snapshot.steps)
+				++gaps;
+			appliedStep = snapshot.steps;
+		}
+
+		// A stall three times as long as the backlog: the oldest steps are dropped, the latest ones kept
+		const std::chrono::steady_clock::duration stall = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			std::chrono::duration<float>(3 * SAMPLE_BACKLOG_STEPS * 0.0005f));
+		const std::chrono::steady_clock::duration stallEnd = time + stall;
+		while (time < stallEnd)
+		{
+			time += std::chrono::milliseconds(10);
+			simulation.advanceTo(start + time);
+		}
+		simulation.acquire();
+		const WorldSnapshot& stalled = simulation.getSnapshot();
+		const bool bounded = stalled.samples.size() == static_cast<std::size_t>(bodyCount) * SAMPLE_BACKLOG_STEPS &&
+			stalled.samples.front().step == stalled.steps - SAMPLE_BACKLOG_STEPS + 1 && stalled.samples.back().step == stalled.steps;
+
+		std::printf("Samples: %llu steps, %zu samples read, %d gaps, %zu samples after a stall\n",
+			static_cast<unsigned long long>(appliedStep), samples, gaps, stalled.samples.size());
+		if (samples != static_cast<std::size_t>(bodyCount) * appliedStep || gaps != 0)
+			return false;
+		if (!bounded)
+		{
+			std::printf("Samples: backlog of a stalled reader not the latest steps\n");
+			return false;
+		}
+		return true;
+	}
+}
+
+int main()
+{
+	const bool passed = testTripleBuffer() & testSamples();
+	std::printf(passed ? "OK\n" : "FAILED\n");
+	return passed ? 0 : 1;
+}